@@ -1,3 +1,4 @@
+#include "FramePresenter.hpp"
 #include "Renderer.hpp"
 #include "Shapes/Circle.hpp"
 #include "Shapes/Collection.hpp"
@@ -28,14 +29,24 @@ int main() {
         10, 40, Colors::YELLOW,
         {{0, 0}, {12, 0}, {16, 10}, {6, 16}, {-4, 10}}, true}));
 
+    auto sink = std::make_unique<MemorySink>();
+    MemorySink *memory = sink.get();
+    FramePresenter presenter(W, H, std::move(sink));
+
     DrawOptions opts{W, H, true};
     renderer.render({scene}, opts);
+    renderer.present(presenter);
+    presenter.flush();
 
-    const Display &d = renderer.getDisplayGrid();
+    Display d;
+    if (!memory->lastFrame(d))
+        return 1;
     int nonBlack = 0;
-    for (const auto &p : d.pixels)
-        if (p.r || p.g || p.b)
+    for (const auto &p : d.pixels) {
+        Color c = PixelFormat::load(p);
+        if (c.r || c.g || c.b)
             nonBlack++;
+    }
 
     printf("Rendered %dx%d grid: %d non-black pixels\n", W, H, nonBlack);
     return nonBlack > 0 ? 0 : 1;
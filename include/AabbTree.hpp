@@ -0,0 +1,101 @@
+#pragma once
+#include "Collider.hpp"
+#include "Utils.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Dynamic bounding volume hierarchy of AABBs. Unlike the CollisionWorld
+// grid its cost does not depend on how sizes vary, so it suits scenes that
+// mix a screen-wide ground with 1-pixel bullets.
+//
+// Leaves store a fattened box (a margin plus the predicted motion), so
+// small moves leave the tree untouched; a proxy that escapes its fat box is
+// reinserted. Insertion descends towards the least perimeter growth, and
+// rotations keep the tree balanced. Entries are opaque pointers, e.g.
+// colliders for pair finding or shapes (see toAabb()) for culling.
+class AabbTree {
+  public:
+    static constexpr int32_t Null = -1;
+
+    explicit AabbTree(float margin = 2.0f);
+
+    int32_t insert(const Aabb &box, void *data);
+    void remove(int32_t proxy);
+    // Updates the box of a proxy; (dx, dy) is its expected motion before the
+    // next move(), which stretches the fat box ahead of it. Returns true if
+    // the proxy was reinserted.
+    bool move(int32_t proxy, const Aabb &box, float dx = 0.0f,
+              float dy = 0.0f);
+    void clear();
+
+    void *data(int32_t proxy) const { return nodes[proxy].data; }
+    const Aabb &fatBox(int32_t proxy) const { return nodes[proxy].box; }
+    size_t size() const { return leafCount; }
+    int height() const { return root == Null ? 0 : nodes[root].height; }
+
+    // Calls fn(proxy) for every proxy whose fat box overlaps `area`. fn
+    // must not query the tree itself.
+    template <typename Fn> void query(const Aabb &area, Fn &&fn) const {
+        if (root == Null)
+            return;
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int32_t id = stack.back();
+            stack.pop_back();
+            const Node &node = nodes[id];
+            if (!node.box.overlaps(area))
+                continue;
+            if (node.isLeaf()) {
+                fn(id);
+            } else {
+                int32_t child2 = node.child2;
+                stack.push_back(node.child1);
+                stack.push_back(child2);
+            }
+        }
+    }
+
+    // Appends every pair of proxies whose fat boxes overlap, once, lower
+    // proxy first. Pairs still need a narrow-phase test.
+    void pairs(std::vector<std::pair<int32_t, int32_t>> &out) const;
+
+  private:
+    struct Node {
+        Aabb box;
+        void *data = nullptr;
+        // Next free node while on the free list.
+        int32_t parent = Null;
+        int32_t child1 = Null;
+        int32_t child2 = Null;
+        // 0 for leaves, -1 for free nodes.
+        int32_t height = 0;
+
+        bool isLeaf() const { return child1 == Null; }
+    };
+
+    int32_t allocateNode();
+    void freeNode(int32_t id);
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    void refit(int32_t id);
+    int32_t balance(int32_t id);
+    int32_t rotate(int32_t id, int32_t up);
+    Aabb fatten(const Aabb &box, float dx, float dy) const;
+
+    float margin;
+    std::vector<Node> nodes;
+    int32_t root = Null;
+    int32_t freeList = Null;
+    size_t leafCount = 0;
+
+    mutable std::vector<int32_t> stack;
+    mutable std::vector<std::pair<int32_t, int32_t>> pairStack;
+};
+
+// Shape bounds, an inclusive pixel range, as an Aabb.
+inline Aabb toAabb(const Bounds &bounds) {
+    return {static_cast<float>(bounds.minX), static_cast<float>(bounds.minY),
+            static_cast<float>(bounds.maxX), static_cast<float>(bounds.maxY)};
+}
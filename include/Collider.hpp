@@ -1,6 +1,8 @@
 #pragma once
 #include <algorithm>
+#include <bit>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <vector>
 
@@ -8,12 +10,16 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+class Shape;
+class CollisionWorld;
 class CircleCollider;
 class RectangleCollider;
 class PolygonCollider;
 class LineSegmentCollider;
 class PointCollider;
 class RegularPolygonCollider;
+class MaskCollider;
+class Texture;
 
 enum class ColliderType {
     CIRCLE,
@@ -21,9 +27,12 @@ enum class ColliderType {
     POLYGON,
     LINE,
     POINT,
-    REGULAR_POLYGON
+    REGULAR_POLYGON,
+    MASK
 };
 
+constexpr int ColliderTypeCount = 7;
+
 class CollisionVisitor {
   public:
     virtual bool visitCircle(const CircleCollider *circle) = 0;
@@ -33,9 +42,50 @@ class CollisionVisitor {
     virtual bool visitPoint(const PointCollider *point) = 0;
     virtual bool
     visitRegularPolygon(const RegularPolygonCollider *regularPolygon) = 0;
+    virtual bool visitMask(const MaskCollider *mask) = 0;
     virtual ~CollisionVisitor() = default;
 };
 
+// World-space axis-aligned box; edges count as overlapping.
+struct Aabb {
+    float minX, minY, maxX, maxY;
+
+    bool overlaps(const Aabb &other) const {
+        return minX <= other.maxX && other.minX <= maxX &&
+               minY <= other.maxY && other.minY <= maxY;
+    }
+};
+
+// Narrow-phase result. The unit normal points from the first collider
+// towards the second; translating the first by -normal * depth (or the
+// second by +normal * depth) separates them.
+struct Contact {
+    float normalX = 0.0f;
+    float normalY = 0.0f;
+    float depth = 0.0f;
+};
+
+// Swept-test result: moving by motion * time brings the mover into contact
+// with the target. The unit normal is the target's surface normal at the
+// contact, facing the mover. Movers that already overlap hit at time 0.
+struct SweepHit {
+    float time = 1.0f;
+    float normalX = 0.0f;
+    float normalY = 0.0f;
+};
+
+// World-space outline of a polygonal collider: vertices, unit edge normals
+// (normal i belongs to the edge from vertex i to vertex i + 1) and bounds.
+struct ColliderOutline {
+    std::vector<std::pair<int, int>> points;
+    std::vector<std::pair<float, float>> normals;
+    Aabb box;
+    bool convex = true;
+
+    // Derives normals and box from points, reusing the vectors' storage.
+    void finish();
+};
+
 class Collidable {
   public:
     virtual bool accept(CollisionVisitor *visitor) const = 0;
@@ -49,30 +99,105 @@ class Collider : public Collidable {
     float y;
     float rotation;
 
-    Collider(float x, float y) : x(x), y(y), rotation(0.0f) {}
-    virtual ~Collider() = default;
+    // Shape this collider was attached to with Shape::addCollider(), if any.
+    Shape *shape = nullptr;
+
+    Collider(ColliderType type, float x, float y)
+        : x(x), y(y), rotation(0.0f), _type(type) {}
+    // Copies geometry only; the copy is not part of any CollisionWorld.
+    Collider(const Collider &other)
+        : x(other.x), y(other.y), rotation(other.rotation),
+          _type(other._type) {}
+    Collider &operator=(const Collider &other) {
+        x = other.x;
+        y = other.y;
+        rotation = other.rotation;
+        moved();
+        return *this;
+    }
+    virtual ~Collider();
+
+    // Dispatches on both types through a compile-time table of pair tests,
+    // without virtual calls.
+    bool intersects(const Collider *other) const;
+    ColliderType getType() const final { return _type; }
+
+    // Like intersects(), and on a hit also fills `contact` with the minimum
+    // translation vector. Convex pairs (circles, rectangles, regular
+    // polygons, convex polygons, and points or lines against those) use the
+    // separating-axis test; other pairs report a zero contact.
+    bool collide(const Collider *other, Contact *contact = nullptr) const;
 
-    virtual bool intersects(const Collider *other) const = 0;
+    // World-space bounding box, used by the CollisionWorld broad phase.
+    virtual Aabb aabb() const = 0;
 
     virtual void translate(float dx, float dy) {
         x += dx;
         y += dy;
+        moved();
     }
 
     virtual void setPosition(int newX, int newY) {
         x = newX;
         y = newY;
+        moved();
     }
 
-    virtual void rotate(float angleDegrees) { rotation += angleDegrees; }
+    virtual void rotate(float angleDegrees) {
+        rotation += angleDegrees;
+        moved();
+    }
 
-    void setX(int newX) { x = newX; }
-    void setY(int newY) { y = newY; }
-    void setRotation(float angleDegrees) { rotation = angleDegrees; }
+    void setX(int newX) {
+        x = newX;
+        moved();
+    }
+    void setY(int newY) {
+        y = newY;
+        moved();
+    }
+    void setRotation(float angleDegrees) {
+        rotation = angleDegrees;
+        moved();
+    }
 
     int getX() const { return x; }
     int getY() const { return y; }
     float getRotation() const { return rotation; }
+    CollisionWorld *world() const { return _world; }
+
+    // Cached world geometry is rebuilt automatically when x, y or rotation
+    // change; call this after editing size or vertex fields directly.
+    void invalidateGeometry() { _geometryValid = false; }
+
+  protected:
+    // Keeps the owning CollisionWorld in sync. Code that writes x, y,
+    // rotation or shape fields directly must call CollisionWorld::update().
+    void moved();
+
+    // True when the cached world geometry no longer matches the current
+    // position and rotation; marks it as current. Not thread safe.
+    bool geometryStale() const {
+        if (_geometryValid && _geometryX == x && _geometryY == y &&
+            _geometryRotation == rotation)
+            return false;
+        _geometryValid = true;
+        _geometryX = x;
+        _geometryY = y;
+        _geometryRotation = rotation;
+        return true;
+    }
+
+  private:
+    friend class CollisionWorld;
+    ColliderType _type;
+    CollisionWorld *_world = nullptr;
+    uint32_t _proxy = 0;
+
+    mutable bool _geometryValid = false;
+    mutable float _geometryX = 0.0f;
+    mutable float _geometryY = 0.0f;
+    mutable float _geometryRotation = 0.0f;
 };
 
 namespace CollisionMath {
@@ -133,6 +258,8 @@ inline bool lineIntersectLine(int x1, int y1, int x2, int y2, int x3, int y3,
 }
 }
 
+// Visitor form of Collider::intersects(), for code written against
+// CollisionVisitor.
 class IntersectionVisitor : public CollisionVisitor {
   private:
     const Collider *other;
@@ -147,64 +274,24 @@ class IntersectionVisitor : public CollisionVisitor {
     bool visitPoint(const PointCollider *point) override;
     bool
     visitRegularPolygon(const RegularPolygonCollider *regularPolygon) override;
-
-  private:
-    bool checkPolygonVsPolygon(const std::vector<std::pair<int, int>> &p1,
-                               const std::vector<std::pair<int, int>> &p2);
-
-    bool circleCircle(const CircleCollider *c1, const CircleCollider *c2);
-    bool circleRectangle(const CircleCollider *circle,
-                         const RectangleCollider *rect);
-    bool circlePoint(const CircleCollider *circle, const PointCollider *point);
-    bool circleLine(const CircleCollider *circle,
-                    const LineSegmentCollider *line);
-    bool circlePolygon(const CircleCollider *circle,
-                       const PolygonCollider *polygon);
-    bool circleRegularPolygon(const CircleCollider *circle,
-                              const RegularPolygonCollider *regularPolygon);
-
-    bool rectangleRectangle(const RectangleCollider *r1,
-                            const RectangleCollider *r2);
-    bool rectanglePoint(const RectangleCollider *rect,
-                        const PointCollider *point);
-    bool rectangleLine(const RectangleCollider *rect,
-                       const LineSegmentCollider *line);
-    bool rectanglePolygon(const RectangleCollider *rect,
-                          const PolygonCollider *polygon);
-    bool rectangleRegularPolygon(const RectangleCollider *rect,
-                                 const RegularPolygonCollider *regularPolygon);
-
-    bool polygonPoint(const PolygonCollider *polygon,
-                      const PointCollider *point);
-    bool polygonLine(const PolygonCollider *polygon,
-                     const LineSegmentCollider *line);
-    bool polygonPolygon(const PolygonCollider *p1, const PolygonCollider *p2);
-    bool polygonRegularPolygon(const PolygonCollider *polygon,
-                               const RegularPolygonCollider *regularPolygon);
-
-    bool linePoint(const LineSegmentCollider *line, const PointCollider *point);
-    bool lineLine(const LineSegmentCollider *l1, const LineSegmentCollider *l2);
-    bool lineRegularPolygon(const LineSegmentCollider *line,
-                            const RegularPolygonCollider *regularPolygon);
-
-    bool pointPoint(const PointCollider *p1, const PointCollider *p2);
-    bool pointRegularPolygon(const PointCollider *point,
-                             const RegularPolygonCollider *regularPolygon);
+    bool visitMask(const MaskCollider *mask) override;
 };
 
 class CircleCollider : public Collider {
   public:
     int radius;
-    CircleCollider(int x, int y, int radius) : Collider(x, y), radius(radius) {}
+    CircleCollider(int x, int y, int radius)
+        : Collider(ColliderType::CIRCLE, x, y), radius(radius) {}
 
     bool accept(CollisionVisitor *visitor) const override {
         return visitor->visitCircle(this);
     }
-    ColliderType getType() const override { return ColliderType::CIRCLE; }
-    bool intersects(const Collider *other) const override {
-        IntersectionVisitor visitor(other);
-        return this->accept(&visitor);
-    }
+    Aabb aabb() const override;
+
+    // Continuous test of moving by (dx, dy) against `target`; true if they
+    // touch before the motion ends.
+    bool sweep(float dx, float dy, const Collider *target,
+               SweepHit *hit = nullptr) const;
 };
 
 class RectangleCollider : public Collider {
@@ -213,31 +300,26 @@ class RectangleCollider : public Collider {
     int height;
 
     RectangleCollider(int x, int y, int width, int height)
-        : Collider(x, y), width(width), height(height) {}
+        : Collider(ColliderType::RECTANGLE, x, y), width(width),
+          height(height) {}
 
     bool accept(CollisionVisitor *visitor) const override {
         return visitor->visitRectangle(this);
     }
-    ColliderType getType() const override { return ColliderType::RECTANGLE; }
-    bool intersects(const Collider *other) const override {
-        IntersectionVisitor visitor(other);
-        return this->accept(&visitor);
-    }
-
-    std::vector<std::pair<int, int>> getCorners() const {
-        std::vector<std::pair<int, int>> corners;
-        float rads = rotation * CollisionMath::DEG_TO_RAD;
-
-        corners.push_back({(int)x, (int)y});
+    Aabb aabb() const override;
 
-        corners.push_back(CollisionMath::rotatePoint(x + width, y, x, y, rads));
-        corners.push_back(
-            CollisionMath::rotatePoint(x + width, y + height, x, y, rads));
-        corners.push_back(
-            CollisionMath::rotatePoint(x, y + height, x, y, rads));
+    // Like CircleCollider::sweep(); the rectangle moves as its AABB, which
+    // is exact only without rotation.
+    bool sweep(float dx, float dy, const Collider *target,
+               SweepHit *hit = nullptr) const;
 
-        return corners;
+    const ColliderOutline &outline() const;
+    const std::vector<std::pair<int, int>> &getCorners() const {
+        return outline().points;
     }
+
+  private:
+    mutable ColliderOutline cached;
 };
 
 class PolygonCollider : public Collider {
@@ -246,30 +328,20 @@ class PolygonCollider : public Collider {
 
     PolygonCollider(int x, int y,
                     const std::vector<std::pair<int, int>> &points)
-        : Collider(x, y), points(points) {}
+        : Collider(ColliderType::POLYGON, x, y), points(points) {}
 
     bool accept(CollisionVisitor *visitor) const override {
         return visitor->visitPolygon(this);
     }
-    ColliderType getType() const override { return ColliderType::POLYGON; }
-    bool intersects(const Collider *other) const override {
-        IntersectionVisitor visitor(other);
-        return this->accept(&visitor);
-    }
-
-    std::vector<std::pair<int, int>> getWorldPoints() const {
-        std::vector<std::pair<int, int>> worldPoints;
-        float rads = rotation * CollisionMath::DEG_TO_RAD;
-        float c = std::cos(rads);
-        float s = std::sin(rads);
+    Aabb aabb() const override;
 
-        for (const auto &p : points) {
-            int rx = static_cast<int>(p.first * c + p.second * s);
-            int ry = static_cast<int>(-p.first * s + p.second * c);
-            worldPoints.push_back({rx + (int)x, ry + (int)y});
-        }
-        return worldPoints;
+    const ColliderOutline &outline() const;
+    const std::vector<std::pair<int, int>> &getWorldPoints() const {
+        return outline().points;
     }
+
+  private:
+    mutable ColliderOutline cached;
 };
 
 class LineSegmentCollider : public Collider {
@@ -278,36 +350,38 @@ class LineSegmentCollider : public Collider {
     int y2;
 
     LineSegmentCollider(int x1, int y1, int x2, int y2)
-        : Collider(x1, y1), x2(x2), y2(y2) {}
+        : Collider(ColliderType::LINE, x1, y1), x2(x2), y2(y2) {}
 
     bool accept(CollisionVisitor *visitor) const override {
         return visitor->visitLine(this);
     }
-    ColliderType getType() const override { return ColliderType::LINE; }
-    bool intersects(const Collider *other) const override {
-        IntersectionVisitor visitor(other);
-        return this->accept(&visitor);
-    }
+    Aabb aabb() const override;
     std::pair<int, int> getP2() const {
         if (rotation == 0.0f)
             return {x2, y2};
-        float rads = rotation * CollisionMath::DEG_TO_RAD;
-        return CollisionMath::rotatePoint(x2, y2, x, y, rads);
+        if (geometryStale()) {
+            float rads = rotation * CollisionMath::DEG_TO_RAD;
+            cachedP2 = CollisionMath::rotatePoint(x2, y2, x, y, rads);
+        }
+        return cachedP2;
     }
+
+  private:
+    mutable std::pair<int, int> cachedP2;
 };
 
 class PointCollider : public Collider {
   public:
-    PointCollider(int x, int y) : Collider(x, y) {}
+    PointCollider(int x, int y) : Collider(ColliderType::POINT, x, y) {}
 
     bool accept(CollisionVisitor *visitor) const override {
         return visitor->visitPoint(this);
     }
-    ColliderType getType() const override { return ColliderType::POINT; }
-    bool intersects(const Collider *other) const override {
-        IntersectionVisitor visitor(other);
-        return this->accept(&visitor);
-    }
+    Aabb aabb() const override;
+
+    // Like CircleCollider::sweep(), for a point.
+    bool sweep(float dx, float dy, const Collider *target,
+               SweepHit *hit = nullptr) const;
 };
 
 class RegularPolygonCollider : public Collider {
@@ -316,7 +390,8 @@ class RegularPolygonCollider : public Collider {
     int radius;
 
     RegularPolygonCollider(int x, int y, int sides, int radius)
-        : Collider(x, y), sides(sides), radius(radius) {}
+        : Collider(ColliderType::REGULAR_POLYGON, x, y), sides(sides),
+          radius(radius) {}
 
     int getSides() const { return sides; }
     int getRadius() const { return radius; }
@@ -327,11 +402,92 @@ class RegularPolygonCollider : public Collider {
     bool accept(CollisionVisitor *visitor) const override {
         return visitor->visitRegularPolygon(this);
     }
-    ColliderType getType() const override {
-        return ColliderType::REGULAR_POLYGON;
+    Aabb aabb() const override;
+
+    const ColliderOutline &outline() const;
+    const std::vector<std::pair<int, int>> &getVertices() const {
+        return outline().points;
     }
-    bool intersects(const Collider *other) const override {
-        IntersectionVisitor visitor(other);
-        return this->accept(&visitor);
+
+  private:
+    mutable ColliderOutline cached;
+};
+
+// Pixel-exact collider: a bitmap whose top-left pixel sits at (x, y). Each
+// solid pixel counts as the point at its integer position, as with
+// PointCollider. Rows are stored as 64-bit words (bit i of word w is column
+// 64 * w + i), so two masks are compared 64 pixels per AND. Rotation is
+// ignored.
+class MaskCollider : public Collider {
+  public:
+    MaskCollider(int x, int y, int width, int height);
+
+    // Pixels with alpha >= alphaThreshold are solid.
+    static MaskCollider fromTexture(const Texture &texture, int x, int y,
+                                    uint8_t alphaThreshold = 128);
+    // Pixels the shape covers when drawn aliased at its current transform;
+    // the mask is placed at the shape's bounds.
+    static MaskCollider fromShape(Shape &shape);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Mask-local coordinates; solid() is false outside the mask.
+    void set(int column, int row, bool solid = true);
+    bool solid(int column, int row) const;
+    // Whether any pixel of `row` in columns [first, last] is solid.
+    bool anySolid(int row, int first, int last) const;
+    // 64 pixels of `row` starting at `column` (lowest bit first); pixels
+    // outside the mask read as empty.
+    uint64_t bitsAt(int row, int column) const;
+
+    // Calls fn(row, first, last) for every horizontal run of solid pixels
+    // in rows [firstRow, lastRow], clipped to the mask. fn returns true to
+    // stop; the result tells whether it did.
+    template <typename Fn>
+    bool forEachRun(int firstRow, int lastRow, Fn &&fn) const {
+        firstRow = std::max(firstRow, 0);
+        lastRow = std::min(lastRow, height - 1);
+        for (int row = firstRow; row <= lastRow; row++) {
+            int column = 0;
+            while (true) {
+                int first = findFrom(row, column, true);
+                if (first >= width)
+                    break;
+                int last = findFrom(row, first, false) - 1;
+                if (fn(row, first, last))
+                    return true;
+                column = last + 1;
+            }
+        }
+        return false;
+    }
+
+    bool accept(CollisionVisitor *visitor) const override {
+        return visitor->visitMask(this);
     }
+    Aabb aabb() const override;
+
+  private:
+    // First column at or after `column` whose pixel is `solid`, or width.
+    int findFrom(int row, int column, bool solid) const {
+        if (column >= width)
+            return width;
+        const uint64_t *words = bits.data() + row * wordsPerRow;
+        int w = column >> 6;
+        uint64_t word = solid ? words[w] : ~words[w];
+        word &= ~0ull << (column & 63);
+        while (!word) {
+            if (++w == wordsPerRow)
+                return width;
+            word = solid ? words[w] : ~words[w];
+        }
+        return std::min(w * 64 + std::countr_zero(word), width);
+    }
+
+    int width;
+    int height;
+    int wordsPerRow;
+    // Bits past the width stay clear, so whole words can be ANDed.
+    std::vector<uint64_t> bits;
 };
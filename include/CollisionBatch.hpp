@@ -0,0 +1,80 @@
+#pragma once
+#include "Collider.hpp"
+#include <cstdint>
+#include <vector>
+
+// Structure-of-arrays collider sets for testing many simple shapes at once,
+// e.g. hundreds of bullets against dozens of enemies. The batch kernels
+// compare one element of the first set against four (SSE2) or eight (AVX2)
+// elements of the second per step, falling back to a scalar loop on other
+// targets.
+//
+// Results match CircleCollider / unrotated RectangleCollider intersects()
+// for integer positions: circles overlap strictly, a circle touching a box
+// counts as a hit, boxes overlap strictly. Points are circles of radius 0
+// and, like PointCollider, hit on the boundary: a point on a circle's edge
+// or at another point's position counts.
+
+struct CircleBatch {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> radius;
+
+    void add(float cx, float cy, float r) {
+        x.push_back(cx);
+        y.push_back(cy);
+        radius.push_back(r);
+    }
+    void add(const CircleCollider &circle) {
+        add(circle.x, circle.y, circle.radius);
+    }
+    void add(const PointCollider &point) { add(point.x, point.y, 0.0f); }
+
+    void clear() {
+        x.clear();
+        y.clear();
+        radius.clear();
+    }
+    uint32_t size() const { return x.size(); }
+};
+
+// Axis-aligned boxes; a RectangleCollider spans [x, x + width].
+struct BoxBatch {
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+
+    void add(const Aabb &box) {
+        minX.push_back(box.minX);
+        minY.push_back(box.minY);
+        maxX.push_back(box.maxX);
+        maxY.push_back(box.maxY);
+    }
+    // Uses the collider's AABB, which is exact only without rotation.
+    void add(const RectangleCollider &rect) { add(rect.aabb()); }
+
+    void clear() {
+        minX.clear();
+        minY.clear();
+        maxX.clear();
+        maxY.clear();
+    }
+    uint32_t size() const { return minX.size(); }
+};
+
+// Indices of a hit pair: `first` into the first set, `second` into the
+// second.
+struct BatchHit {
+    uint32_t first;
+    uint32_t second;
+};
+
+// Each function appends every overlapping pair to `hits`, ordered by first
+// then second index.
+void batchCircleCircle(const CircleBatch &a, const CircleBatch &b,
+                       std::vector<BatchHit> &hits);
+void batchCircleBox(const CircleBatch &circles, const BoxBatch &boxes,
+                    std::vector<BatchHit> &hits);
+void batchBoxBox(const BoxBatch &a, const BoxBatch &b,
+                 std::vector<BatchHit> &hits);
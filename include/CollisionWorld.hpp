@@ -0,0 +1,149 @@
+#pragma once
+#include "Collider.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using ColliderPair = std::pair<Collider *, Collider *>;
+
+enum class ContactPhase { Enter, Stay, Exit };
+
+struct ContactEvent {
+    Collider *first;
+    Collider *second;
+    ContactPhase phase;
+};
+
+// Nearest hit of a ray or shape cast. distance is measured along the cast
+// direction; the normal is the collider's surface normal at the hit.
+struct CastHit {
+    Collider *collider = nullptr;
+    float distance = 0.0f;
+    float normalX = 0.0f;
+    float normalY = 0.0f;
+};
+
+// Broad phase for scenes with many colliders. Registered colliders are
+// binned by their AABB into a uniform grid of square cells, hashed into a
+// fixed number of buckets; a collider re-bins itself whenever it moves, and
+// only touches the buckets when its cell range changes. Pair and area
+// queries then test only colliders that share a cell instead of every pair.
+//
+// The world does not own its colliders. A collider belongs to at most one
+// world and leaves it when destroyed.
+class CollisionWorld {
+  public:
+    // cellSize is in pixels and should be around the size of a typical
+    // collider; bucketCount is rounded up to a power of two.
+    explicit CollisionWorld(float cellSize = 16.0f, int bucketCount = 256);
+    ~CollisionWorld();
+
+    CollisionWorld(const CollisionWorld &) = delete;
+    CollisionWorld &operator=(const CollisionWorld &) = delete;
+
+    void add(Collider *collider);
+    void remove(Collider *collider);
+    // Re-bins a collider. Collider setters call this; needed only after
+    // writing collider fields directly.
+    void update(Collider *collider);
+    void clear();
+
+    size_t size() const { return proxies.size() - freeProxies.size(); }
+
+    // Registered pairs whose AABBs overlap, each reported once. The
+    // returned vector is reused by the next call.
+    const std::vector<ColliderPair> &candidatePairs();
+
+    // Candidate pairs that also pass the narrow phase.
+    void collidingPairs(std::vector<ColliderPair> &out);
+
+    // Narrow-phase tests the candidate pairs and appends an event for every
+    // pair that started touching, is still touching or stopped touching
+    // since the previous call. Results are cached per pair: a pair where
+    // neither collider moved since it was last tested is not tested again.
+    // Pairs of a removed collider are dropped without an Exit event.
+    void updateContacts(std::vector<ContactEvent> &events);
+
+    // Appends registered colliders whose AABB overlaps `area`.
+    void query(const Aabb &area, std::vector<Collider *> &out) const;
+
+    // Appends registered colliders that intersect `collider`, which does
+    // not need to be registered itself and is never reported.
+    void query(const Collider *collider, std::vector<Collider *> &out) const;
+
+    // Nearest registered collider on the ray from (x, y) in direction
+    // (dirX, dirY), which need not be normalized, up to maxDistance. Walks
+    // the grid cells along the ray, nearest first, so the cost depends on
+    // the cells crossed rather than on the number of colliders.
+    bool raycast(float x, float y, float dirX, float dirY, float maxDistance,
+                 CastHit *hit = nullptr) const;
+
+    // Like raycast(), moving `shape` along the direction. Casts circles,
+    // points and rectangles (as their AABB, see RectangleCollider::sweep());
+    // other shapes never hit. `shape` does not need to be registered and is
+    // never reported.
+    bool shapeCast(const Collider *shape, float dirX, float dirY,
+                   float maxDistance, CastHit *hit = nullptr) const;
+
+  private:
+    struct CellRange {
+        int minX, minY, maxX, maxY;
+
+        bool operator==(const CellRange &other) const {
+            return minX == other.minX && minY == other.minY &&
+                   maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    struct Proxy {
+        Collider *collider;
+        Aabb box;
+        CellRange cells;
+        // Moved since the last updateContacts().
+        bool moved;
+    };
+
+    // Pair of proxy ids, lower id in the high half, and its last
+    // narrow-phase result.
+    struct CachedPair {
+        uint64_t key;
+        bool touching;
+    };
+
+    CellRange cellRange(const Aabb &box) const;
+    std::vector<uint32_t> &bucket(int cellX, int cellY);
+    const std::vector<uint32_t> &bucket(int cellX, int cellY) const;
+    void insertCells(uint32_t id);
+    void removeCells(uint32_t id);
+
+    // Starts a new round of visitStamps.
+    void nextVisitStamp() const;
+
+    // Visits each registered collider overlapping `area` once.
+    template <typename Fn> void forEachOverlap(const Aabb &area, Fn &&fn) const;
+
+    // Visits each registered collider binned within (marginX, marginY) cells
+    // of a cell the segment (x, y) + t * (dx, dy), t in [0, 1], crosses,
+    // once and in the order the segment reaches the cells. Stops before a
+    // cell the segment enters after `limit`, which fn may lower.
+    template <typename Fn>
+    void forEachAlongSegment(float x, float y, float dx, float dy, int marginX,
+                             int marginY, const float &limit, Fn &&fn) const;
+
+    float inverseCellSize;
+    uint32_t bucketMask;
+    std::vector<std::vector<uint32_t>> buckets;
+
+    std::vector<Proxy> proxies;
+    std::vector<uint32_t> freeProxies;
+    std::vector<ColliderPair> pairs;
+
+    // Sorted by key; the second vector is scratch for the next update.
+    std::vector<CachedPair> contacts;
+    std::vector<CachedPair> nextContacts;
+
+    // Per-proxy stamp so area queries report colliders spanning several
+    // cells only once.
+    mutable std::vector<uint32_t> visitStamps;
+    mutable uint32_t visitStamp = 0;
+};
@@ -12,15 +12,25 @@ struct PaintCtx {
     float tex_D, tex_E, tex_F;
 };
 
+// How overlapping or self-intersecting polygon regions are filled.
+enum class FillRule { EvenOdd, NonZero };
+
 void transformPoint(int x, int y, const Matrix2D &m, int &outX, int &outY);
 Color sampleTexture(const PaintCtx &ctx, int x, int y);
+// Single-pixel write that resolves texture, opacity and clipping on every
+// call; rasterizer loops go through PixelPipeline::dispatch() instead.
 void addPixel(Display &grid, int x, int y, float alpha, const PaintCtx &ctx);
 void bresenhamLine(Display &grid, int x0, int y0, int x1, int y1,
                    const PaintCtx &ctx);
 void wuLine(Display &grid, int x0, int y0, int x1, int y1, const PaintCtx &ctx);
+// Filled circle, as drawn by Circle in aliased mode.
+void midpointCircle(Display &grid, int cx, int cy, int r, const PaintCtx &ctx);
+// Anti-aliased outline, filled when `fill` is set.
+void aaCircle(Display &grid, int cx, int cy, int r, bool fill,
+              const PaintCtx &ctx);
 void scanlineFill(Display &grid,
                   const std::vector<std::pair<int, int>> &vertices,
-                  const PaintCtx &ctx);
+                  const PaintCtx &ctx, FillRule rule = FillRule::EvenOdd);
 void scanlineFill(Display &grid,
                   const std::array<std::pair<int, int>, 4> &vertices,
                   const PaintCtx &ctx);
@@ -0,0 +1,132 @@
+#pragma once
+#include "Utils.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Lock-free queue for exactly one producer thread and one consumer thread.
+template <typename T, size_t Capacity> class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0,
+                  "capacity must be a power of two");
+
+  public:
+    bool push(const T &item) {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        items[tail & (Capacity - 1)] = item;
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &item) {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == tail.load(std::memory_order_acquire))
+            return false;
+        item = items[head & (Capacity - 1)];
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    std::array<T, Capacity> items{};
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
+
+// Destination for finished frames. present() runs on the presenter's output
+// thread and must not keep a reference to the frame after returning.
+class PresentSink {
+  public:
+    virtual ~PresentSink() = default;
+    virtual void present(const Display &frame, uint64_t frameIndex) = 0;
+};
+
+// Keeps a copy of the most recent frame.
+class MemorySink : public PresentSink {
+  public:
+    void present(const Display &frame, uint64_t frameIndex) override;
+
+    // Copies the last presented frame into `out`; returns false if nothing
+    // was presented yet.
+    bool lastFrame(Display &out, uint64_t *frameIndex = nullptr) const;
+    uint64_t presentedFrames() const { return frames.load(); }
+
+  private:
+    mutable std::mutex mutex;
+    Display last;
+    uint64_t lastIndex = 0;
+    std::atomic<uint64_t> frames{0};
+};
+
+// Appends every frame to a file as a binary PPM image, giving a PPM stream
+// that most image tools and ffmpeg read directly.
+class FileSink : public PresentSink {
+  public:
+    explicit FileSink(const std::string &path);
+    ~FileSink() override;
+
+    bool isOpen() const { return file != nullptr; }
+    void present(const Display &frame, uint64_t frameIndex) override;
+
+  private:
+    FILE *file = nullptr;
+    std::vector<uint8_t> row;
+};
+
+// N-buffered frame output. The render thread takes a free buffer with
+// acquire(), fills it and hands it over with submit(); a dedicated output
+// thread passes submitted frames to the sink in order and recycles the
+// buffers. Buffer hand-off uses two single-producer/single-consumer
+// queues, so frame N+1 rasterizes while frame N is being transferred.
+// acquire() blocks only when every buffer is still queued for output.
+class FramePresenter {
+  public:
+    static constexpr int MaxBuffers = 8;
+
+    FramePresenter(int width, int height, std::unique_ptr<PresentSink> sink,
+                   int bufferCount = 3);
+    ~FramePresenter();
+
+    FramePresenter(const FramePresenter &) = delete;
+    FramePresenter &operator=(const FramePresenter &) = delete;
+
+    // Must be followed by submit() before the next acquire().
+    Display &acquire();
+    void submit();
+
+    // Blocks until every submitted frame has been presented.
+    void flush();
+
+    int width() const { return frameWidth; }
+    int height() const { return frameHeight; }
+    uint64_t submittedFrames() const { return submitted; }
+    uint64_t presentedFrames() const { return presented.load(); }
+
+  private:
+    void outputLoop();
+
+    int frameWidth;
+    int frameHeight;
+    std::unique_ptr<PresentSink> sink;
+    std::vector<Display> buffers;
+
+    SpscQueue<int, MaxBuffers> freeBuffers;
+    SpscQueue<int, MaxBuffers> pendingFrames;
+    // Bumped after every push so the other side can block with wait().
+    std::atomic<uint32_t> freeSignal{0};
+    std::atomic<uint32_t> pendingSignal{0};
+
+    int acquired = -1;
+    uint64_t submitted = 0;
+    std::atomic<uint64_t> presented{0};
+    std::atomic<bool> running{true};
+    std::thread output;
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include "Color.hpp"
+#include <cstdint>
+
+// Storage format of Display pixels, chosen at compile time by defining
+// RENDERER_PIXEL_FORMAT to one of the values below (the desktop build
+// exposes it as a CMake cache variable). Rasterizers read and write pixels
+// only through PixelFormat::load()/store(), so each format gets its own
+// specialized blend and store paths.
+#define RENDERER_PIXEL_RGBA8888 0
+#define RENDERER_PIXEL_RGB565 1
+#define RENDERER_PIXEL_RGB888 2
+#define RENDERER_PIXEL_INDEXED8 3
+
+#ifndef RENDERER_PIXEL_FORMAT
+#define RENDERER_PIXEL_FORMAT RENDERER_PIXEL_RGBA8888
+#endif
+
+// Every format provides:
+//   load(p)          stored pixel -> Color (alpha 255)
+//   store(c)         Color -> stored pixel, alpha dropped
+//   transparent()    value offscreen layers are cleared to; it loads as
+//                    (near) black, so blending over it is blending over black
+//   isTransparent(p) whether a layer pixel was never written
+
+struct RGBA8888Format {
+    using Pixel = Color;
+
+    static Color load(const Pixel &p) { return p; }
+    static Pixel store(const Color &c) { return Color(c.r, c.g, c.b, 255); }
+    static Pixel transparent() { return Color(0, 0, 0, 0); }
+    static bool isTransparent(const Pixel &p) { return p.a == 0; }
+};
+
+// 16-bit 5-6-5. The transparent key is black with the lowest blue bit set,
+// so only stored colours (0, 0, 8..15) are mistaken for it.
+struct RGB565Format {
+    using Pixel = uint16_t;
+
+    static Color load(Pixel p) {
+        uint8_t r = (p >> 11) & 0x1F;
+        uint8_t g = (p >> 5) & 0x3F;
+        uint8_t b = p & 0x1F;
+        return Color((r << 3) | (r >> 2), (g << 2) | (g >> 4),
+                     (b << 3) | (b >> 2));
+    }
+    static Pixel store(const Color &c) {
+        return ((c.r >> 3) << 11) | ((c.g >> 2) << 5) | (c.b >> 3);
+    }
+    static Pixel transparent() { return 0x0001; }
+    static bool isTransparent(Pixel p) { return p == 0x0001; }
+};
+
+struct Rgb888 {
+    uint8_t r, g, b;
+};
+
+// Packed 24-bit; the transparent key is (0, 0, 1).
+struct RGB888Format {
+    using Pixel = Rgb888;
+
+    static Color load(const Pixel &p) { return Color(p.r, p.g, p.b); }
+    static Pixel store(const Color &c) { return {c.r, c.g, c.b}; }
+    static Pixel transparent() { return {0, 0, 1}; }
+    static bool isTransparent(const Pixel &p) {
+        return p.r == 0 && p.g == 0 && p.b == 1;
+    }
+};
+
+// Global palette for the indexed format. store() maps a colour to the
+// nearest entry through a 4-4-4 RGB lookup table that set() rebuilds.
+// The last entry is reserved as the transparent key and is never chosen.
+namespace Palette {
+constexpr int Size = 256;
+constexpr uint8_t TransparentIndex = Size - 1;
+
+extern Color entries[Size];
+extern uint8_t lookup[4096];
+
+// Replaces entries 0..count-1 (count is capped at Size - 1); entries past
+// count keep their colour but are no longer chosen by store(). Not thread
+// safe: call before rendering.
+void set(const Color *colors, int count);
+} // namespace Palette
+
+struct Indexed8Format {
+    using Pixel = uint8_t;
+
+    static Color load(Pixel p) { return Palette::entries[p]; }
+    static Pixel store(const Color &c) {
+        return Palette::lookup[((c.r >> 4) << 8) | ((c.g >> 4) << 4) |
+                               (c.b >> 4)];
+    }
+    static Pixel transparent() { return Palette::TransparentIndex; }
+    static bool isTransparent(Pixel p) { return p == Palette::TransparentIndex; }
+};
+
+#if RENDERER_PIXEL_FORMAT == RENDERER_PIXEL_RGBA8888
+using PixelFormat = RGBA8888Format;
+#elif RENDERER_PIXEL_FORMAT == RENDERER_PIXEL_RGB565
+using PixelFormat = RGB565Format;
+#elif RENDERER_PIXEL_FORMAT == RENDERER_PIXEL_RGB888
+using PixelFormat = RGB888Format;
+#elif RENDERER_PIXEL_FORMAT == RENDERER_PIXEL_INDEXED8
+using PixelFormat = Indexed8Format;
+#else
+#error "Unknown RENDERER_PIXEL_FORMAT"
+#endif
+
+using Pixel = PixelFormat::Pixel;
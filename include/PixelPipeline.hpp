@@ -0,0 +1,285 @@
+#pragma once
+#include "DrawUtils.hpp"
+#include "Texture.hpp"
+#include "Utils.hpp"
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+// Compile-time specialized per-pixel write paths. A rasterizer writes its
+// loop once as a generic lambda and PixelPipeline::dispatch() instantiates
+// it for the paint source (solid / textured, per texture wrap mode and
+// filter), opacity and clipping chosen once per draw, so the inner loop
+// carries no branches on any of them.
+namespace PixelPipeline {
+
+struct SolidPaint {
+    static constexpr bool textured = false;
+    Color color;
+
+    explicit SolidPaint(const PaintCtx &ctx) : color(ctx.color) {}
+    Color at(int, int) const { return color; }
+};
+
+// Texture paint through the affine mapping PaintCtx::tex_A..tex_F, held in
+// 16.16 fixed point so texel lookups need no float math or rounding.
+// Sampler is one of the Texture sampler variants, for mip level `level`.
+// Nearest sampling takes the closest texel; bilinear blends the four
+// around the exact position.
+//
+// 16.16 holds coordinates up to +-32767 texels. Repeating textures wrap
+// the origin terms into the first period, so only the distance a draw
+// spans has to stay within that; clamped textures need the coordinates
+// themselves in range, and beyond it they saturate.
+template <typename Sampler, bool Bilinear> struct TexturedPaint {
+    static constexpr bool textured = true;
+    Sampler sampler;
+    uint32_t alpha;
+    int32_t a, b, c;
+    int32_t d, e, f;
+
+    TexturedPaint(const PaintCtx &ctx, const Sampler &sampler, int level = 0)
+        : sampler(sampler), alpha(ctx.color.a),
+          a(toFixed(std::ldexp(ctx.tex_A, -level))),
+          b(toFixed(std::ldexp(ctx.tex_B, -level))),
+          c(toFixed(wrap(levelOrigin(ctx.tex_C, level), periodU(sampler))) +
+            Bias),
+          d(toFixed(std::ldexp(ctx.tex_D, -level))),
+          e(toFixed(std::ldexp(ctx.tex_E, -level))),
+          f(toFixed(wrap(levelOrigin(ctx.tex_F, level), periodV(sampler))) +
+            Bias) {}
+
+    Color at(int x, int y) const { return texel(u(x, y), v(x, y)); }
+
+    // Fixed-point texture coordinates of pixel (x, y).
+    int32_t u(int x, int y) const {
+        return static_cast<int32_t>(static_cast<int64_t>(a) * x +
+                                    static_cast<int64_t>(b) * y + c);
+    }
+    int32_t v(int x, int y) const {
+        return static_cast<int32_t>(static_cast<int64_t>(d) * x +
+                                    static_cast<int64_t>(e) * y + f);
+    }
+
+    // Texels of a row of pixels from (x, y) rightwards, one per next():
+    // the coordinates step by (tex_A, tex_D) with two adds per pixel.
+    struct Span {
+        const TexturedPaint &paint;
+        int32_t u, v;
+
+        Color next() {
+            Color texColor = paint.texel(u, v);
+            u += paint.a;
+            v += paint.d;
+            return texColor;
+        }
+    };
+    Span span(int x, int y) const { return {*this, u(x, y), v(x, y)}; }
+
+    Color texel(int32_t u, int32_t v) const {
+        Color texColor;
+        if constexpr (Bilinear) {
+            int x = u >> 16, y = v >> 16;
+            uint32_t fx = (u >> 8) & 0xFF, fy = (v >> 8) & 0xFF;
+            Color c00 = sampler.at(x, y), c10 = sampler.at(x + 1, y);
+            Color c01 = sampler.at(x, y + 1), c11 = sampler.at(x + 1, y + 1);
+            auto mix = [&](uint32_t p00, uint32_t p10, uint32_t p01,
+                           uint32_t p11) {
+                uint32_t top = p00 * (256 - fx) + p10 * fx;
+                uint32_t bottom = p01 * (256 - fx) + p11 * fx;
+                return static_cast<uint8_t>(
+                    (top * (256 - fy) + bottom * fy) >> 16);
+            };
+            texColor = Color(mix(c00.r, c10.r, c01.r, c11.r),
+                             mix(c00.g, c10.g, c01.g, c11.g),
+                             mix(c00.b, c10.b, c01.b, c11.b),
+                             mix(c00.a, c10.a, c01.a, c11.a));
+        } else {
+            texColor = sampler.at(u >> 16, v >> 16);
+        }
+        // Rounded so an opaque texel at full paint alpha stays at 255.
+        texColor.a = (texColor.a * alpha + 255) >> 8;
+        return texColor;
+    }
+
+  private:
+    // Nearest sampling rounds by flooring half a texel further on;
+    // bilinear keeps the exact position, with texel centres on integers.
+    static constexpr int32_t Bias = Bilinear ? 0 : 0x8000;
+
+    // Texel j of level L covers base texels [j * 2^L, (j + 1) * 2^L), so
+    // base coordinate t maps to (t + 0.5) / 2^L - 0.5.
+    static float levelOrigin(float t, int level) {
+        return level ? std::ldexp(t + 0.5f, -level) - 0.5f : t;
+    }
+
+    // Texels after which the sampler repeats, or 0 if it does not.
+    static int periodU(const Sampler &sampler) {
+        if constexpr (std::is_same_v<Sampler, Texture::RepeatPow2Sampler>)
+            return sampler.maskX + 1;
+        else if constexpr (std::is_same_v<Sampler, Texture::RepeatSampler>)
+            return sampler.width;
+        else
+            return 0;
+    }
+    static int periodV(const Sampler &sampler) {
+        if constexpr (std::is_same_v<Sampler, Texture::RepeatPow2Sampler>)
+            return sampler.maskY + 1;
+        else if constexpr (std::is_same_v<Sampler, Texture::RepeatSampler>)
+            return sampler.height;
+        else
+            return 0;
+    }
+
+    // Shifting by whole periods picks the same texels.
+    static float wrap(float t, int period) {
+        return period ? t - period * std::floor(t / period) : t;
+    }
+
+    // Saturates instead of overflowing; lround() is not used since long is
+    // 32 bits on the ESP32.
+    static int32_t toFixed(float value) {
+        float scaled = std::round(value * 65536.0f);
+        if (scaled >= 2147483520.0f)
+            return INT32_MAX;
+        if (!(scaled > -2147483648.0f))
+            return INT32_MIN;
+        return static_cast<int32_t>(scaled);
+    }
+};
+
+// Calls fn(paint) with the TexturedPaint for ctx's texture, which must be
+// set. With mipmaps the level is chosen from how many texels one pixel
+// step covers.
+template <typename Fn> void withTexturedPaint(const PaintCtx &ctx, Fn &&fn) {
+    const Texture &texture = *ctx.texture;
+    bool bilinear = texture.getFilter() == TextureFilter::Bilinear;
+    int level = 0;
+    if (texture.mipLevels() > 0)
+        level = texture.mipLevelFor(
+            std::max(std::hypot(ctx.tex_A, ctx.tex_D),
+                     std::hypot(ctx.tex_B, ctx.tex_E)));
+
+    texture.withSampler(
+        [&](const auto &sampler) {
+            using Sampler = std::decay_t<decltype(sampler)>;
+            if constexpr (std::is_same_v<Sampler, Texture::InvalidSampler>) {
+                fn(TexturedPaint<Sampler, false>(ctx, sampler));
+            } else if (bilinear) {
+                fn(TexturedPaint<Sampler, true>(ctx, sampler, level));
+            } else {
+                fn(TexturedPaint<Sampler, false>(ctx, sampler, level));
+            }
+        },
+        level);
+}
+
+template <typename Paint, bool Opaque, bool Clipped> class PixelWriter {
+  public:
+    static constexpr bool textured = Paint::textured;
+    static_assert(!(Opaque && textured), "textures may carry alpha");
+
+    PixelWriter(Display &grid, const Paint &paint, uint8_t paintAlpha)
+        : grid(grid), paint(paint), paintAlpha(paintAlpha),
+          clip(grid.bounds()) {}
+
+    bool contains(int x, int y) const {
+        if constexpr (Clipped)
+            return x >= clip.minX && x <= clip.maxX && y >= clip.minY &&
+                   y <= clip.maxY;
+        return true;
+    }
+
+    // Full-coverage write at the paint's alpha.
+    void plot(int x, int y) const {
+        if constexpr (Clipped) {
+            if (!contains(x, y))
+                return;
+        }
+        Pixel *p = pixel(x, y);
+        Color src = paint.at(x, y);
+        if constexpr (Opaque) {
+            *p = PixelFormat::store(src);
+        } else {
+            blend(p, src, textured ? (paintAlpha * src.a) >> 8 : paintAlpha);
+        }
+    }
+
+    // Write with partial coverage (0-255) on top of the paint's alpha.
+    void plot(int x, int y, uint32_t coverage) const {
+        if constexpr (Clipped) {
+            if (!contains(x, y))
+                return;
+        }
+        uint32_t alpha = (coverage * paintAlpha + 255) >> 8;
+        if (alpha == 0)
+            return;
+        Color src = paint.at(x, y);
+        if constexpr (textured)
+            alpha = (alpha * src.a) >> 8;
+        blend(pixel(x, y), src, alpha);
+    }
+
+    // Anti-aliased line weighting: mixes by coverage only, like wuLine has
+    // always done.
+    void mix(int x, int y, uint32_t coverage) const {
+        if constexpr (Clipped) {
+            if (!contains(x, y))
+                return;
+        }
+        blend(pixel(x, y), paint.at(x, y), coverage);
+    }
+
+  private:
+    Pixel *pixel(int x, int y) const {
+        return &grid.pixels[(y - clip.minY) * grid.width + (x - clip.minX)];
+    }
+
+    static void blend(Pixel *p, const Color &src, uint32_t alpha) {
+        uint32_t invAlpha = 255 - alpha;
+        Color dst = PixelFormat::load(*p);
+        dst.r = (src.r * alpha + dst.r * invAlpha) >> 8;
+        dst.g = (src.g * alpha + dst.g * invAlpha) >> 8;
+        dst.b = (src.b * alpha + dst.b * invAlpha) >> 8;
+        *p = PixelFormat::store(dst);
+    }
+
+    Display &grid;
+    Paint paint;
+    uint32_t paintAlpha;
+    Bounds clip;
+};
+
+// Calls fn(writer) with the writer variant matching ctx. `extent` is the
+// screen area the draw may touch; clipping is compiled out when it lies
+// fully inside the target.
+template <typename Fn>
+void dispatch(Display &grid, const PaintCtx &ctx, const Bounds &extent,
+              Fn &&fn) {
+    bool clipped = !grid.bounds().contains(extent);
+    uint8_t alpha = ctx.color.a;
+
+    if (ctx.texture) {
+        withTexturedPaint(ctx, [&](const auto &paint) {
+            using Paint = std::decay_t<decltype(paint)>;
+            if (clipped)
+                fn(PixelWriter<Paint, false, true>(grid, paint, alpha));
+            else
+                fn(PixelWriter<Paint, false, false>(grid, paint, alpha));
+        });
+    } else if (alpha == 255) {
+        SolidPaint paint(ctx);
+        if (clipped)
+            fn(PixelWriter<SolidPaint, true, true>(grid, paint, alpha));
+        else
+            fn(PixelWriter<SolidPaint, true, false>(grid, paint, alpha));
+    } else {
+        SolidPaint paint(ctx);
+        if (clipped)
+            fn(PixelWriter<SolidPaint, false, true>(grid, paint, alpha));
+        else
+            fn(PixelWriter<SolidPaint, false, false>(grid, paint, alpha));
+    }
+}
+
+} // namespace PixelPipeline
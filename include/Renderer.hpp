@@ -1,9 +1,13 @@
 #pragma once
 #include "Font/Font.hpp"
+#include "FramePresenter.hpp"
+#include "SceneStore.hpp"
 #include "Shapes/Collection.hpp"
 #include "Utils.hpp"
+#include "WorkerPool.hpp"
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class Renderer {
@@ -12,12 +16,73 @@ class Renderer {
     int height;
     Display displayGrid;
 
+    int tileSize = 0;
+    std::unique_ptr<WorkerPool> workerPool;
+    std::vector<Display> regionBuffers;
+
+    std::vector<Collection *> sortedCollections;
+    std::vector<Shape *> drawables;
+    std::vector<Bounds> drawableBounds;
+
+    // Screen regions rasterized this frame and the drawables touching each.
+    std::vector<Bounds> regions;
+    std::vector<std::vector<uint32_t>> regionItems;
+
+    struct TrackedShape {
+        Bounds bounds;
+        uint32_t frame;
+    };
+    bool dirtyTracking = false;
+    bool fullRedraw = true;
+    uint32_t frameCounter = 0;
+    std::unordered_map<const Shape *, TrackedShape> trackedShapes;
+    std::vector<Bounds> damage;
+    // Boxes of text drawn since the last tracked render.
+    std::vector<Bounds> textDamage;
+
+    void prepareDrawables();
+    void binTiles();
+    void collectDamage();
+    void mergeDamage();
+    void binDamage();
+    void rasterizeRegions(const DrawOptions &options, bool clearFirst);
+    void rasterizeRegion(Display &buffer, const Bounds &region,
+                         const std::vector<uint32_t> &items,
+                         const DrawOptions &options, bool clearFirst);
+
   public:
     Renderer(int width, int height);
 
     void render(const std::vector<std::shared_ptr<Collection>> &collections,
                 const DrawOptions &options);
 
+    // Draws a flat scene straight into the frame buffer on the calling
+    // thread. Tiling and dirty tracking apply to collections only; the next
+    // tracked collection render repaints the whole screen.
+    void render(SceneStore &scene, const DrawOptions &options);
+
+    // Bins shapes into tileSize x tileSize screen tiles by bounding box and
+    // rasterizes the tiles in parallel on `workers` threads (0 = one per
+    // core). Draw order inside every tile matches the sequential path.
+    // tileSize <= 0 switches back to single-threaded rendering.
+    void setTiling(int tileSize, unsigned workers = 0);
+
+    // Keeps the previous frame's pixels and re-rasterizes only the screen
+    // regions where a shape appeared, disappeared, moved or changed since
+    // the last render(). Damaged regions are cleared to black first, so the
+    // renderer owns the background; clear() forces one full redraw. Text
+    // from drawText() counts as damage on the following render(), so text
+    // drawn after each render() is replaced cleanly when it changes.
+    void setDirtyTracking(bool enabled);
+
+    // Hands the finished frame to `presenter` by swapping buffers instead of
+    // copying, so the next frame can be rasterized while this one is output.
+    // Afterwards the frame buffer holds an older frame: clear() before
+    // drawing, except with dirty tracking, where the presented frame is
+    // copied back to keep incremental updates valid.
+    void present(FramePresenter &presenter);
+
+    // Writes straight into the frame buffer, on top of what render() drew.
     void drawText(const std::string &text, int x, int y, const Font &font,
                   const Color &color, bool wrap = false);
 
@@ -0,0 +1,126 @@
+#pragma once
+#include "DrawUtils.hpp"
+#include "Shapes/Circle.hpp"
+#include "Shapes/LineSegment.hpp"
+#include "Shapes/Rectangle.hpp"
+#include "Shapes/Shape.hpp"
+#include "Utils.hpp"
+#include <cstdint>
+#include <vector>
+
+// Stable reference to a SceneStore node. A handle to a destroyed node is
+// detected by its generation and ignored.
+struct SceneHandle {
+    static constexpr uint32_t None = UINT32_MAX;
+
+    uint32_t index = None;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == None; }
+};
+
+// Flat alternative to Collection trees for large scenes. Nodes live in one
+// array and refer to their parent by index; primitive data lives in
+// contiguous per-type arrays. draw() updates world transforms in one
+// parent-first pass and rasterizes in one z-ordered pass, without shared_ptr
+// traffic or virtual calls.
+//
+// Draw order is by z across the whole store, then by creation order; unlike
+// Collection, children are not grouped under their parent's z. Primitives
+// are solid-coloured.
+class SceneStore {
+  public:
+    // A group only carries a transform for its children.
+    SceneHandle createGroup(const ShapeParams &params,
+                            SceneHandle parent = {});
+    SceneHandle createCircle(const CircleParams &params,
+                             SceneHandle parent = {});
+    SceneHandle createRectangle(const RectangleParams &params,
+                                SceneHandle parent = {});
+    SceneHandle createLine(const LineSegmentParams &params,
+                           SceneHandle parent = {});
+
+    // Destroys the node together with its whole subtree.
+    void destroy(SceneHandle handle);
+    void clear();
+
+    bool valid(SceneHandle handle) const;
+    size_t size() const { return nodes.size() - freeNodes.size(); }
+
+    void setPosition(SceneHandle handle, float x, float y);
+    void translate(SceneHandle handle, float dx, float dy);
+    void setRotation(SceneHandle handle, float angle);
+    void setPivot(SceneHandle handle, int x, int y);
+    void setColor(SceneHandle handle, const Color &color);
+    void setZ(SceneHandle handle, int z);
+
+    // Screen-space bounds of the node as of the last draw(), including the
+    // anti-aliasing fringe. Empty for groups and invalid handles.
+    Bounds bounds(SceneHandle handle) const;
+
+    void draw(Display &target, const DrawOptions &options);
+
+  private:
+    enum class Kind : uint8_t { Group, Circle, Rectangle, Line };
+
+    struct Node {
+        float x, y;
+        float cosAngle, sinAngle;
+        float angle;
+        int pivotX, pivotY;
+        int z;
+        Color color;
+        uint32_t parent;
+        uint32_t generation;
+        uint32_t data; // index into the array for `kind`
+        uint32_t sequence;
+        uint16_t depth;
+        Kind kind;
+        bool alive;
+    };
+
+    struct CircleData {
+        uint32_t node;
+        int radius;
+        bool fill;
+    };
+
+    struct RectangleData {
+        uint32_t node;
+        int width, height;
+        bool fill;
+    };
+
+    struct LineData {
+        uint32_t node;
+        int dx, dy; // end point relative to the node origin
+    };
+
+    SceneHandle createNode(const ShapeParams &params, Kind kind,
+                           uint32_t data, SceneHandle parent);
+    Node *resolve(SceneHandle handle);
+    const Node *resolve(SceneHandle handle) const;
+    void releaseNode(uint32_t index);
+    void rebuildOrder();
+    void updateTransforms();
+    Bounds primitiveBounds(const Node &node) const;
+
+    template <typename T>
+    void removeData(std::vector<T> &items, uint32_t index);
+
+    std::vector<Node> nodes;
+    std::vector<Matrix2D> world;
+    std::vector<Bounds> nodeBounds;
+    std::vector<uint32_t> freeNodes;
+
+    std::vector<CircleData> circles;
+    std::vector<RectangleData> rectangles;
+    std::vector<LineData> lines;
+
+    // Live nodes with parents before children, and primitives by (z,
+    // creation); rebuilt after structural or z changes.
+    std::vector<uint32_t> transformOrder;
+    std::vector<uint32_t> drawOrder;
+    bool orderDirty = false;
+    uint32_t nextSequence = 0;
+};
@@ -20,13 +20,7 @@ class Circle : public Shape {
     std::unique_ptr<Collider> defaultCollider() override;
     void drawAntiAliased(Display &displayGrid) override;
     void drawAliased(Display &displayGrid) override;
+    Bounds computeBounds() override;
     int radius() const;
 
-  private:
-    void drawHorizontalLine(Display &displayGrid, int x1, int x2, int y,
-                            const PaintCtx &ctx);
-    void drawAntiAliasedPoint(Display &displayGrid, int cx, int cy, int x,
-                              int y, float intensity, const PaintCtx &ctx);
-    void fillCircle(Display &displayGrid, int cx, int cy, int r,
-                    const PaintCtx &ctx);
 };
@@ -15,14 +15,48 @@ class Collection : public Shape {
 
     void drawAliased(Display &displayGrid) override;
     void drawAntiAliased(Display &displayGrid) override;
+    Bounds computeBounds() override;
+    void collectDrawables(std::vector<Shape *> &out,
+                          const DrawOptions &options) override;
 
     void clear();
 
     void markDirty() override;
 
+    // Rasterizes the children once into an offscreen layer and blits it on
+    // later draws until a descendant changes. The layer starts transparent
+    // and is composited as opaque pixels, so translucent colours and
+    // anti-aliased edges inside it are baked against black: meant for static
+    // scenery that is opaque or drawn first.
+    void setCacheable(bool cacheable);
+    bool isCacheable() const { return cacheable; }
+
+  protected:
+    void onDescendantChanged() override;
+
   private:
+    void sortIfNeeded();
+    void drawChildren(Display &displayGrid, bool antialias);
+    void drawLayer(Display &displayGrid, bool antialias);
+    void buildLayer(const Bounds &clip, bool antialias);
+    void blitLayer(Display &displayGrid) const;
+
     std::vector<std::shared_ptr<Shape>> shapes;
 
+    // Draw order of `shapes`; raw pointers so per-frame walks do not touch
+    // the reference counts.
     bool needsSort = true;
-    std::vector<std::shared_ptr<Shape>> cachedSortedShapes;
+    std::vector<Shape *> cachedSortedShapes;
+
+    // Layer pixels plus the runs of covered pixels in each row, in layer
+    // coordinates; blitting copies the runs.
+    struct LayerRun {
+        int x, y, length;
+    };
+    bool cacheable = false;
+    bool layerValid = false;
+    bool layerAntialias = false;
+    Bounds layerClip;
+    Display layer;
+    std::vector<LayerRun> layerRuns;
 };
@@ -20,4 +20,5 @@ class LineSegment : public Shape {
     std::unique_ptr<Collider> defaultCollider() override;
     void drawAntiAliased(Display &displayGrid) override;
     void drawAliased(Display &displayGrid) override;
+    Bounds computeBounds() override;
 };
@@ -7,4 +7,5 @@ class Point : public Shape {
     std::unique_ptr<Collider> defaultCollider() override;
     void drawAntiAliased(Display &displayGrid) override;
     void drawAliased(Display &displayGrid) override;
+    Bounds computeBounds() override;
 };
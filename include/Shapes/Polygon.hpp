@@ -6,23 +6,34 @@
 struct PolygonParams : public ShapeParams {
     std::vector<std::pair<int, int>> vertices;
     bool fill;
+    FillRule fillRule;
 
     PolygonParams(int x, int y, const Color &color,
                   const std::vector<std::pair<int, int>> &vertices,
-                  bool fill = false, int z = 0)
-        : ShapeParams(x, y, color, z), vertices(vertices), fill(fill) {}
+                  bool fill = false, int z = 0,
+                  FillRule fillRule = FillRule::EvenOdd)
+        : ShapeParams(x, y, color, z), vertices(vertices), fill(fill),
+          fillRule(fillRule) {}
 };
 
 class Polygon : public Shape {
   private:
     std::vector<std::pair<int, int>> vertices;
     bool fill;
+    FillRule _fillRule;
 
   public:
     Polygon(const PolygonParams &params);
     std::unique_ptr<Collider> defaultCollider() override;
     void drawAntiAliased(Display &displayGrid) override;
     void drawAliased(Display &displayGrid) override;
+    Bounds computeBounds() override;
+
+    FillRule fillRule() const { return _fillRule; }
+    void setFillRule(FillRule rule) {
+        _fillRule = rule;
+        requestRedraw();
+    }
 
   private:
     std::vector<std::pair<int, int>> getTransformedVertices();
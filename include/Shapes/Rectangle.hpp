@@ -24,6 +24,7 @@ class Rectangle : public Shape {
     std::unique_ptr<Collider> defaultCollider() override;
     void drawAntiAliased(Display &displayGrid) override;
     void drawAliased(Display &displayGrid) override;
+    Bounds computeBounds() override;
     int width() const { return _width; }
     int height() const { return _height; }
 
@@ -41,6 +41,7 @@ class RegularPolygon : public Shape {
     std::unique_ptr<Collider> defaultCollider() override;
     void drawAntiAliased(Display &displayGrid) override;
     void drawAliased(Display &displayGrid) override;
+    Bounds computeBounds() override;
     int sides() const;
     int radius();
 
@@ -10,6 +10,10 @@ struct DrawOptions {
     int screen_width;
     int screen_height;
     bool antialias;
+
+    Bounds screen() const {
+        return {0, 0, screen_width - 1, screen_height - 1};
+    }
 };
 
 struct Matrix2D {
@@ -18,6 +22,8 @@ struct Matrix2D {
     float e = 0.0f, f = 0.0f; // Translation (Position)
 };
 
+Matrix2D multiplyMatrices(const Matrix2D &m1, const Matrix2D &m2);
+
 struct ShapeParams {
     float x;
     float y;
@@ -35,6 +41,9 @@ class Shape {
     bool _trigCacheValid = false;
     bool _texTrigCacheValid = false;
 
+    Bounds _cachedBounds;
+    bool _boundsValid = false;
+
   protected:
     float _x;
     float _y;
@@ -74,6 +83,7 @@ class Shape {
 
     Matrix2D _cachedGlobalMatrix;
     bool _isDirty = true;
+    bool _needsRedraw = true;
 
     std::unique_ptr<Collider> _collider;
 
@@ -83,11 +93,23 @@ class Shape {
     void updateTrigCache();
     void updateTextureTrigCache();
 
-    float _tex_A, _tex_B, _tex_C;
-    float _tex_D, _tex_E, _tex_F;
+    float _tex_A = 0.0f, _tex_B = 0.0f, _tex_C = 0.0f;
+    float _tex_D = 0.0f, _tex_E = 0.0f, _tex_F = 0.0f;
 
     void updateTextureMatrix();
 
+    // Marks a change that alters the shape's pixels but not its transform.
+    void requestRedraw() {
+        _needsRedraw = true;
+        notifyAncestors();
+    }
+
+    // Calls onDescendantChanged() on every ancestor.
+    void notifyAncestors();
+
+    // Called when the pixels of any shape below this one may have changed.
+    virtual void onDescendantChanged() {}
+
   public:
     Shape(const ShapeParams &params);
     virtual ~Shape();
@@ -102,7 +124,42 @@ class Shape {
     virtual void drawAliased(Display &pixels) = 0;
     virtual std::unique_ptr<Collider> defaultCollider() = 0;
 
-    virtual void markDirty() { _isDirty = true; };
+    virtual void markDirty() {
+        _isDirty = true;
+        _needsRedraw = true;
+        invalidateBounds();
+        notifyAncestors();
+    };
+
+    // Drops the cached bounds of this shape and of every ancestor, whose
+    // bounds include it.
+    void invalidateBounds();
+
+    // Returns whether the shape changed since the last call and resets the
+    // flag. Used by the renderer's damage tracking.
+    bool consumeRedraw() {
+        bool pending = _needsRedraw;
+        _needsRedraw = false;
+        return pending;
+    }
+
+    // Screen-space area the shape may touch when drawn, including the
+    // anti-aliasing fringe. Shapes that do not override this are treated as
+    // covering the whole screen.
+    virtual Bounds computeBounds() { return Bounds::unbounded(); }
+
+    // computeBounds() cached until the shape, or for a collection any of its
+    // children, is marked dirty. Used to cull offscreen shapes and subtrees.
+    const Bounds &bounds();
+
+    // Appends the leaf shapes to rasterize, in draw order.
+    virtual void collectDrawables(std::vector<Shape *> &out,
+                                  const DrawOptions &options);
+
+    // Updates per-frame paint state (screen pivot, texture matrix). After
+    // this the draw* methods only read shape state, so they may run
+    // concurrently on different target buffers.
+    void prepareDraw();
 
     void draw(Display &pixels, const DrawOptions &options);
 
@@ -121,6 +178,9 @@ class Shape {
     void addCollider(std::unique_ptr<Collider> collider = nullptr);
     void removeCollider();
     bool intersects(const std::shared_ptr<Shape> &other);
+    // Collider::collide() between the shapes' colliders.
+    bool collide(const std::shared_ptr<Shape> &other,
+                 Contact *contact = nullptr);
 
     void setTexture(Texture *texture);
     void setTextureScale(float scaleX, float scaleY);
@@ -161,27 +221,40 @@ class Shape {
 
     void setX(int x) {
         _x = x;
+        markDirty();
         if (_collider)
             _collider->setX(x);
     }
 
     void setY(int y) {
         _y = y;
+        markDirty();
         if (_collider)
             _collider->setY(y);
     }
 
-    void setColor(const Color &color) { _color = color; }
+    void setColor(const Color &color) {
+        _color = color;
+        requestRedraw();
+    }
     void setZ(int z);
 
     void setRotationAngle(float angle) {
         _rotation.angle = angle;
+        invalidateTrigCache();
+        markDirty();
         if (_collider)
             _collider->setRotation(angle);
     }
 
-    void setRotationX(int x) { _rotation.x = x; }
-    void setRotationY(int y) { _rotation.y = y; }
+    void setRotationX(int x) {
+        _rotation.x = x;
+        markDirty();
+    }
+    void setRotationY(int y) {
+        _rotation.y = y;
+        markDirty();
+    }
 
     void setScaleX(float scaleX) { _scale.x = scaleX; }
     void setScaleY(float scaleY) { _scale.y = scaleY; }
@@ -191,17 +264,26 @@ class Shape {
     void setUVScaleX(float scaleX) {
         _uvTransform.scaleX = scaleX;
         _uvTransform.invScaleX = 1.0f / scaleX;
+        requestRedraw();
     }
 
     void setUVScaleY(float scaleY) {
         _uvTransform.scaleY = scaleY;
         _uvTransform.invScaleY = 1.0f / scaleY;
+        requestRedraw();
     }
 
-    void setUVOffsetX(float offsetX) { _uvTransform.offsetX = offsetX; }
-    void setUVOffsetY(float offsetY) { _uvTransform.offsetY = offsetY; }
+    void setUVOffsetX(float offsetX) {
+        _uvTransform.offsetX = offsetX;
+        requestRedraw();
+    }
+    void setUVOffsetY(float offsetY) {
+        _uvTransform.offsetY = offsetY;
+        requestRedraw();
+    }
     void setUVRotation(float rotation) {
         _uvTransform.rotation = rotation;
         invalidateTexTrigCache();
+        requestRedraw();
     }
 };
@@ -0,0 +1,16 @@
+#pragma once
+#include "Utils.hpp"
+#include <cstdint>
+
+// Horizontal span kernels shared by the fill rasterizers. They blend as
+// (src * alpha + dst * (255 - alpha)) >> 8 per channel and write alpha 255;
+// fully opaque pixels are stored as-is and fully transparent ones are
+// skipped. Destinations are in the compile-time pixel format; for RGBA8888
+// SSE2 and AVX2 versions are used when the compiler targets them, otherwise
+// a scalar loop runs.
+
+// Blends `color` over count pixels with a single alpha value.
+void blendSolidSpan(Pixel *dst, int count, const Color &color, uint8_t alpha);
+
+// Blends src over dst pixel by pixel, using each source pixel's alpha.
+void blendSpan(Pixel *dst, const Color *src, int count);
@@ -4,23 +4,156 @@
 #include <string>
 #include <vector>
 
+// How texel coordinates outside the texture are mapped back into it.
+enum class WrapMode { Repeat, Clamp };
+
+// How texels are picked for a pixel: the closest one, or a blend of the
+// four around the exact position.
+enum class TextureFilter { Nearest, Bilinear };
+
 class Texture {
   private:
     std::vector<Color, PsramAllocator<Color>> pixels;
     int width;
     int height;
-    std::string wrapMode;
+    WrapMode wrapMode;
+    TextureFilter filter = TextureFilter::Nearest;
     bool valid;
+    // log2 of the row stride when it and both sides are powers of two, so
+    // repeat can wrap with masks; otherwise -1.
+    int widthShift;
+
+    // Set on sub-textures handed out by a TextureAtlas: the texels are the
+    // width x height region at (originX, originY) of the atlas page.
+    const Texture *page = nullptr;
+    int originX = 0;
+    int originY = 0;
+    friend class TextureAtlas;
+
+    // Box-filtered copies at half, quarter, ... size; mips[0] is level 1.
+    struct MipLevel {
+        std::vector<Color, PsramAllocator<Color>> pixels;
+        int width;
+        int height;
+        int widthShift;
+    };
+    std::vector<MipLevel> mips;
 
   public:
-Texture(const std::vector<Color, PsramAllocator<Color>> &pixels, int width, int height);
+    // Texel lookups with the wrap mode resolved at compile time and no
+    // validity checks. Rows are `stride` texels apart, which is wider than
+    // the texture for atlas sub-textures. Get one through withSampler().
+    struct RepeatPow2Sampler {
+        const Color *pixels;
+        int shift;
+        int maskX;
+        int maskY;
+
+        Color at(int u, int v) const {
+            return pixels[((v & maskY) << shift) | (u & maskX)];
+        }
+    };
+
+    struct RepeatSampler {
+        const Color *pixels;
+        int width;
+        int height;
+        int stride;
+
+        Color at(int u, int v) const {
+            if (static_cast<unsigned>(u) >= static_cast<unsigned>(width)) {
+                u %= width;
+                if (u < 0)
+                    u += width;
+            }
+            if (static_cast<unsigned>(v) >= static_cast<unsigned>(height)) {
+                v %= height;
+                if (v < 0)
+                    v += height;
+            }
+            return pixels[v * stride + u];
+        }
+    };
+
+    struct ClampSampler {
+        const Color *pixels;
+        int width;
+        int height;
+        int stride;
+
+        Color at(int u, int v) const {
+            u = std::max(0, std::min(width - 1, u));
+            v = std::max(0, std::min(height - 1, v));
+            return pixels[v * stride + u];
+        }
+    };
+
+    // Stands in for a texture without pixels.
+    struct InvalidSampler {
+        Color at(int, int) const { return Color(0, 0, 0, 255); }
+    };
+
+    Texture(const std::vector<Color, PsramAllocator<Color>> &pixels, int width, int height);
     Texture();
 
     static bool fromBMP(const std::string &filename, Texture &outTexture,
                         bool littleEndian = true);
 
+    // Single texel lookup. Loops should use withSampler() instead, which
+    // resolves the wrap mode and validity once.
     Color sample(int u, int v) const;
+
+    // Calls fn(sampler) with the sampler variant for this texture's wrap
+    // mode and size. `level` picks a mip level, clamped to those built;
+    // its texel coordinates are the base ones divided by 2^level.
+    template <typename Fn> void withSampler(Fn &&fn, int level = 0) const {
+        if (!valid || (!page && pixels.empty()) || width <= 0 ||
+            height <= 0) {
+            fn(InvalidSampler{});
+            return;
+        }
+        level = std::min(level, mipLevels());
+        const Color *data = pixels.data();
+        int w = width, h = height, stride = width, shift = widthShift;
+        if (page) {
+            stride = page->width;
+            data = page->pixels.data() + originY * stride + originX;
+        } else if (level > 0) {
+            const MipLevel &mip = mips[level - 1];
+            data = mip.pixels.data();
+            w = stride = mip.width;
+            h = mip.height;
+            shift = mip.widthShift;
+        }
+
+        if (wrapMode == WrapMode::Clamp)
+            fn(ClampSampler{data, w, h, stride});
+        else if (shift >= 0)
+            fn(RepeatPow2Sampler{data, shift, w - 1, h - 1});
+        else
+            fn(RepeatSampler{data, w, h, stride});
+    }
+
+    // Builds the mip pyramid down to 1x1, each level averaging 2x2 texels
+    // of the one above. Draws that shrink the texture then sample the
+    // level closest to one texel per pixel, which aliases less and reads
+    // far less memory. Costs a third more texture memory. Only textures
+    // whose sides are powers of two get mipmaps; others, and atlas
+    // sub-textures, always sample the base level.
+    void generateMipmaps();
+    // Number of levels below the base texture; 0 without mipmaps.
+    int mipLevels() const { return static_cast<int>(mips.size()); }
+    // Level for a draw covering `texelsPerPixel` base texels per screen
+    // pixel along its steepest direction.
+    int mipLevelFor(float texelsPerPixel) const;
+
+    void setWrapMode(WrapMode mode) { wrapMode = mode; }
+    // "repeat" or "clamp"; anything else selects repeat.
     void setWrapMode(const std::string &mode);
+    WrapMode getWrapMode() const { return wrapMode; }
+
+    void setFilter(TextureFilter newFilter) { filter = newFilter; }
+    TextureFilter getFilter() const { return filter; }
 
     int getWidth() const { return width; }
     int getHeight() const { return height; }
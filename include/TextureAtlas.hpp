@@ -0,0 +1,45 @@
+#pragma once
+#include "Texture.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Packs many small textures into one page, so sprites share a single hot
+// allocation instead of scattering across memory. add() copies the texels
+// into the page and returns a sub-texture for Shape::setTexture(). Its
+// texture coordinates, wrap mode and filter behave as for a standalone
+// texture of the same size, and wrapping never reaches neighbouring
+// regions. Sub-textures live as long as the atlas.
+class TextureAtlas {
+  public:
+    TextureAtlas(int width, int height);
+
+    TextureAtlas(const TextureAtlas &) = delete;
+    TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+    // nullptr when the texture is invalid or there is no room left.
+    Texture *add(const Texture &texture);
+    Texture *addBMP(const std::string &filename, bool littleEndian = true);
+
+    const Texture &texture() const { return page; }
+    size_t size() const { return regions.size(); }
+    // Fraction of the page covered by sub-textures.
+    float occupancy() const;
+
+  private:
+    // Skyline of the bottom-left packer: the lowest free row of every
+    // column, as runs of equal height from left to right.
+    struct Segment {
+        int x;
+        int y;
+        int width;
+    };
+
+    bool findPosition(int width, int height, int &outX, int &outY) const;
+    void place(int x, int y, int width, int height);
+
+    Texture page;
+    std::vector<Segment> skyline;
+    std::vector<std::unique_ptr<Texture>> regions;
+    long usedArea = 0;
+};
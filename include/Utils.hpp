@@ -1,4 +1,8 @@
 #pragma once
+#include "Color.hpp"
+#include "PixelFormat.hpp"
+#include <algorithm>
+#include <climits>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
@@ -43,24 +47,85 @@ template <class T> struct PsramAllocator {
 template <class T> using PsramAllocator = std::allocator<T>;
 #endif
 
-struct Color {
-    uint8_t r;
-    uint8_t g;
-    uint8_t b;
-    uint8_t a;
+// Inclusive integer screen-space rectangle. Default-constructed bounds are
+// empty.
+struct Bounds {
+    int minX = 0;
+    int minY = 0;
+    int maxX = -1;
+    int maxY = -1;
 
-    Color() : r(0), g(0), b(0), a(255) {}
-    Color(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255)
-        : r(r), g(g), b(b), a(a) {}
+    Bounds() = default;
+    Bounds(int minX, int minY, int maxX, int maxY)
+        : minX(minX), minY(minY), maxX(maxX), maxY(maxY) {}
+
+    static Bounds unbounded() { return {INT_MIN, INT_MIN, INT_MAX, INT_MAX}; }
+
+    bool empty() const { return maxX < minX || maxY < minY; }
+
+    bool intersects(const Bounds &other) const {
+        return !empty() && !other.empty() && minX <= other.maxX &&
+               other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+    }
+
+    bool contains(const Bounds &other) const {
+        return !other.empty() && minX <= other.minX && other.maxX <= maxX &&
+               minY <= other.minY && other.maxY <= maxY;
+    }
+
+    Bounds intersection(const Bounds &other) const {
+        return {std::max(minX, other.minX), std::max(minY, other.minY),
+                std::min(maxX, other.maxX), std::min(maxY, other.maxY)};
+    }
+
+    void expand(int x, int y) {
+        if (empty()) {
+            *this = {x, y, x, y};
+            return;
+        }
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+
+    void expand(const Bounds &other) {
+        if (other.empty())
+            return;
+        if (empty()) {
+            *this = other;
+            return;
+        }
+        minX = std::min(minX, other.minX);
+        minY = std::min(minY, other.minY);
+        maxX = std::max(maxX, other.maxX);
+        maxY = std::max(maxY, other.maxY);
+    }
+
+    Bounds padded(int amount) const {
+        if (empty())
+            return *this;
+        return {minX - amount, minY - amount, maxX + amount, maxY + amount};
+    }
 };
 
-bool operator==(const Color &lhs, const Color &rhs);
-bool operator!=(const Color &lhs, const Color &rhs);
+bool operator==(const Bounds &lhs, const Bounds &rhs);
+bool operator!=(const Bounds &lhs, const Bounds &rhs);
 
+// Frame or tile buffer in the compile-time pixel format (PixelFormat.hpp).
+// Read and write pixels through PixelFormat::load()/store().
 struct Display {
-    std::vector<Color, PsramAllocator<Color>> pixels;
+    std::vector<Pixel, PsramAllocator<Pixel>> pixels;
     int width = 0;
     int height = 0;
+    // Screen position of pixels[0]. Non-zero for buffers that cover only
+    // part of the screen (tiles, offscreen layers).
+    int originX = 0;
+    int originY = 0;
+
+    Bounds bounds() const {
+        return {originX, originY, originX + width - 1, originY + height - 1};
+    }
 };
 
 class Texture;
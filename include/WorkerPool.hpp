@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent set of worker threads that execute batches of independent jobs.
+// The calling thread takes part in every batch as worker 0.
+class WorkerPool {
+  public:
+    using Job = std::function<void(int job, unsigned worker)>;
+
+    // workers is the total number of threads including the caller; 0 picks
+    // std::thread::hardware_concurrency().
+    explicit WorkerPool(unsigned workers = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    unsigned size() const { return threads.size() + 1; }
+
+    // Runs job(0..jobCount-1) across all workers and returns once every job
+    // has finished.
+    void run(int jobCount, const Job &job);
+
+  private:
+    void workerLoop(unsigned worker);
+    void drain(unsigned worker);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const Job *currentJob = nullptr;
+    int jobCount = 0;
+    std::atomic<int> nextJob{0};
+    unsigned busyWorkers = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,257 @@
+#include "AabbTree.hpp"
+#include <algorithm>
+#include <cmath>
+
+static Aabb merged(const Aabb &a, const Aabb &b) {
+    return {std::min(a.minX, b.minX), std::min(a.minY, b.minY),
+            std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+}
+
+static bool contains(const Aabb &outer, const Aabb &inner) {
+    return outer.minX <= inner.minX && outer.minY <= inner.minY &&
+           inner.maxX <= outer.maxX && inner.maxY <= outer.maxY;
+}
+
+static float perimeter(const Aabb &box) {
+    return 2.0f * ((box.maxX - box.minX) + (box.maxY - box.minY));
+}
+
+// Fat boxes reach this many moves ahead along the predicted motion.
+static constexpr float Lookahead = 4.0f;
+
+AabbTree::AabbTree(float margin) : margin(margin) {}
+
+Aabb AabbTree::fatten(const Aabb &box, float dx, float dy) const {
+    Aabb fat = {box.minX - margin, box.minY - margin, box.maxX + margin,
+                box.maxY + margin};
+    (dx < 0.0f ? fat.minX : fat.maxX) += Lookahead * dx;
+    (dy < 0.0f ? fat.minY : fat.maxY) += Lookahead * dy;
+    return fat;
+}
+
+int32_t AabbTree::allocateNode() {
+    int32_t id;
+    if (freeList == Null) {
+        id = nodes.size();
+        nodes.emplace_back();
+    } else {
+        id = freeList;
+        freeList = nodes[id].parent;
+        nodes[id] = Node();
+    }
+    return id;
+}
+
+void AabbTree::freeNode(int32_t id) {
+    nodes[id].parent = freeList;
+    nodes[id].height = -1;
+    freeList = id;
+}
+
+int32_t AabbTree::insert(const Aabb &box, void *data) {
+    int32_t id = allocateNode();
+    nodes[id].box = fatten(box, 0.0f, 0.0f);
+    nodes[id].data = data;
+    insertLeaf(id);
+    leafCount++;
+    return id;
+}
+
+void AabbTree::remove(int32_t proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    leafCount--;
+}
+
+bool AabbTree::move(int32_t proxy, const Aabb &box, float dx, float dy) {
+    Aabb fat = fatten(box, dx, dy);
+    const Aabb &current = nodes[proxy].box;
+    if (contains(current, box)) {
+        // Still inside; keep it unless the fat box has grown far too loose,
+        // e.g. stretched by a fast move that has since stopped.
+        float slackX = 4.0f * margin + Lookahead * std::fabs(dx);
+        float slackY = 4.0f * margin + Lookahead * std::fabs(dy);
+        Aabb loose = {fat.minX - slackX, fat.minY - slackY, fat.maxX + slackX,
+                      fat.maxY + slackY};
+        if (contains(loose, current))
+            return false;
+    }
+
+    removeLeaf(proxy);
+    nodes[proxy].box = fat;
+    insertLeaf(proxy);
+    return true;
+}
+
+void AabbTree::clear() {
+    nodes.clear();
+    root = Null;
+    freeList = Null;
+    leafCount = 0;
+}
+
+void AabbTree::refit(int32_t id) {
+    Node &node = nodes[id];
+    node.box = merged(nodes[node.child1].box, nodes[node.child2].box);
+    node.height =
+        1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+}
+
+void AabbTree::insertLeaf(int32_t leaf) {
+    if (root == Null) {
+        root = leaf;
+        nodes[leaf].parent = Null;
+        return;
+    }
+
+    // Descend while pushing the leaf into a child is cheaper than pairing
+    // it with the current node. Every ancestor's box grows either way, which
+    // the inherited cost accounts for.
+    const Aabb box = nodes[leaf].box;
+    int32_t index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node &node = nodes[index];
+        float combined = perimeter(merged(node.box, box));
+        float cost = 2.0f * combined;
+        float inherited = 2.0f * (combined - perimeter(node.box));
+
+        auto descentCost = [&](int32_t child) {
+            const Node &c = nodes[child];
+            float grown = perimeter(merged(box, c.box));
+            return (c.isLeaf() ? grown : grown - perimeter(c.box)) + inherited;
+        };
+        float cost1 = descentCost(node.child1);
+        float cost2 = descentCost(node.child2);
+        if (cost < cost1 && cost < cost2)
+            break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = nodes[sibling].parent;
+    int32_t parent = allocateNode();
+    nodes[parent].parent = oldParent;
+    nodes[parent].child1 = sibling;
+    nodes[parent].child2 = leaf;
+    nodes[sibling].parent = parent;
+    nodes[leaf].parent = parent;
+    if (oldParent == Null)
+        root = parent;
+    else if (nodes[oldParent].child1 == sibling)
+        nodes[oldParent].child1 = parent;
+    else
+        nodes[oldParent].child2 = parent;
+
+    for (index = parent; index != Null; index = nodes[index].parent) {
+        index = balance(index);
+        refit(index);
+    }
+}
+
+void AabbTree::removeLeaf(int32_t leaf) {
+    if (leaf == root) {
+        root = Null;
+        return;
+    }
+
+    int32_t parent = nodes[leaf].parent;
+    int32_t grandParent = nodes[parent].parent;
+    int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2
+                                                   : nodes[parent].child1;
+    freeNode(parent);
+    nodes[sibling].parent = grandParent;
+    if (grandParent == Null) {
+        root = sibling;
+        return;
+    }
+    if (nodes[grandParent].child1 == parent)
+        nodes[grandParent].child1 = sibling;
+    else
+        nodes[grandParent].child2 = sibling;
+
+    for (int32_t index = grandParent; index != Null;
+         index = nodes[index].parent) {
+        index = balance(index);
+        refit(index);
+    }
+}
+
+int32_t AabbTree::balance(int32_t id) {
+    const Node &node = nodes[id];
+    if (node.isLeaf() || node.height < 2)
+        return id;
+    int32_t skew = nodes[node.child2].height - nodes[node.child1].height;
+    if (skew > 1)
+        return rotate(id, node.child2);
+    if (skew < -1)
+        return rotate(id, node.child1);
+    return id;
+}
+
+// Lifts child `up` into the place of `id`. `up` keeps its taller child and
+// gives the shorter one to `id`, which keeps its other child.
+int32_t AabbTree::rotate(int32_t id, int32_t up) {
+    Node &node = nodes[id];
+    Node &lifted = nodes[up];
+    int32_t other = node.child1 == up ? node.child2 : node.child1;
+    int32_t taller = lifted.child1;
+    int32_t shorter = lifted.child2;
+    if (nodes[taller].height < nodes[shorter].height)
+        std::swap(taller, shorter);
+
+    int32_t parent = node.parent;
+    lifted.parent = parent;
+    if (parent == Null)
+        root = up;
+    else if (nodes[parent].child1 == id)
+        nodes[parent].child1 = up;
+    else
+        nodes[parent].child2 = up;
+
+    lifted.child1 = id;
+    lifted.child2 = taller;
+    node.parent = up;
+    node.child1 = other;
+    node.child2 = shorter;
+    nodes[shorter].parent = id;
+
+    refit(id);
+    refit(up);
+    return up;
+}
+
+// Every overlapping pair of leaves meets at its lowest common ancestor, with
+// one leaf under each child. So the pairs are found by descending both
+// children of each internal node together, splitting the larger box first,
+// which shares the work that per-leaf queries would repeat.
+void AabbTree::pairs(std::vector<std::pair<int32_t, int32_t>> &out) const {
+    std::vector<std::pair<int32_t, int32_t>> &pending = pairStack;
+    for (int32_t id = 0; id < static_cast<int32_t>(nodes.size()); id++) {
+        const Node &node = nodes[id];
+        if (node.height < 1)
+            continue;
+
+        pending.clear();
+        pending.push_back({node.child1, node.child2});
+        while (!pending.empty()) {
+            auto [a, b] = pending.back();
+            pending.pop_back();
+            const Node &nodeA = nodes[a];
+            const Node &nodeB = nodes[b];
+            if (!nodeA.box.overlaps(nodeB.box))
+                continue;
+
+            if (nodeA.isLeaf() && nodeB.isLeaf()) {
+                out.push_back({std::min(a, b), std::max(a, b)});
+            } else if (nodeB.isLeaf() ||
+                       (!nodeA.isLeaf() &&
+                        perimeter(nodeA.box) >= perimeter(nodeB.box))) {
+                pending.push_back({nodeA.child1, b});
+                pending.push_back({nodeA.child2, b});
+            } else {
+                pending.push_back({a, nodeB.child1});
+                pending.push_back({a, nodeB.child2});
+            }
+        }
+    }
+}
@@ -1,38 +1,353 @@
 #include "Collider.hpp"
+#include "CollisionWorld.hpp"
 #include <algorithm>
 #include <cmath>
 #include <vector>
 
-static std::vector<std::pair<int, int>>
-getRegularPolyVertices(const RegularPolygonCollider *rp) {
-    std::vector<std::pair<int, int>> vertices;
-    int sides = rp->getSides();
+void ColliderOutline::finish() {
+    box = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+    normals.resize(points.size());
+    bool turnsLeft = false;
+    bool turnsRight = false;
+    for (size_t i = 0; i < points.size(); i++) {
+        const auto &p = points[i];
+        const auto &next = points[(i + 1) % points.size()];
+        const auto &after = points[(i + 2) % points.size()];
+        long cross = static_cast<long>(next.first - p.first) *
+                         (after.second - next.second) -
+                     static_cast<long>(next.second - p.second) *
+                         (after.first - next.first);
+        turnsLeft |= cross > 0;
+        turnsRight |= cross < 0;
+
+        box.minX = std::min(box.minX, static_cast<float>(p.first));
+        box.minY = std::min(box.minY, static_cast<float>(p.second));
+        box.maxX = std::max(box.maxX, static_cast<float>(p.first));
+        box.maxY = std::max(box.maxY, static_cast<float>(p.second));
+
+        float nx = static_cast<float>(next.second - p.second);
+        float ny = static_cast<float>(p.first - next.first);
+        float length = std::sqrt(nx * nx + ny * ny);
+        normals[i] = length > 0.0f ? std::make_pair(nx / length, ny / length)
+                                   : std::make_pair(0.0f, 0.0f);
+    }
+    convex = !(turnsLeft && turnsRight);
+}
 
-    float rotationRad = rp->getRotation() * CollisionMath::DEG_TO_RAD;
+// Outlines keep their vector storage, so rebuilding after a move does not
+// allocate once the vertex count is stable.
+const ColliderOutline &RectangleCollider::outline() const {
+    if (!geometryStale())
+        return cached;
+    float rads = rotation * CollisionMath::DEG_TO_RAD;
+    cached.points.resize(4);
+    cached.points[0] = {(int)x, (int)y};
+    cached.points[1] = CollisionMath::rotatePoint(x + width, y, x, y, rads);
+    cached.points[2] =
+        CollisionMath::rotatePoint(x + width, y + height, x, y, rads);
+    cached.points[3] = CollisionMath::rotatePoint(x, y + height, x, y, rads);
+    cached.finish();
+    return cached;
+}
+
+const ColliderOutline &PolygonCollider::outline() const {
+    if (!geometryStale())
+        return cached;
+    float rads = rotation * CollisionMath::DEG_TO_RAD;
+    float c = std::cos(rads);
+    float s = std::sin(rads);
+
+    cached.points.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        const auto &p = points[i];
+        int rx = static_cast<int>(p.first * c + p.second * s);
+        int ry = static_cast<int>(-p.first * s + p.second * c);
+        cached.points[i] = {rx + (int)x, ry + (int)y};
+    }
+    cached.finish();
+    return cached;
+}
 
+const ColliderOutline &RegularPolygonCollider::outline() const {
+    if (!geometryStale())
+        return cached;
+    float rotationRad = rotation * CollisionMath::DEG_TO_RAD;
     float c = std::cos(rotationRad);
     float s = std::sin(rotationRad);
     float angleStep = 2.0f * M_PI / sides;
-
     float startAngle = -M_PI / 2.0f;
 
+    cached.points.resize(std::max(sides, 0));
     for (int i = 0; i < sides; i++) {
         float angle = i * angleStep + startAngle;
 
-        float localX = rp->radius * std::cos(angle);
-        float localY = rp->radius * std::sin(angle);
+        float localX = radius * std::cos(angle);
+        float localY = radius * std::sin(angle);
+
+        int finalX = static_cast<int>(localX * c + localY * s) + x;
+        int finalY = static_cast<int>(-localX * s + localY * c) + y;
+
+        cached.points[i] = {finalX, finalY};
+    }
+    cached.finish();
+    return cached;
+}
+
+Collider::~Collider() {
+    if (_world)
+        _world->remove(this);
+}
+
+void Collider::moved() {
+    if (_world)
+        _world->update(this);
+}
+
+// Boxes are rounded outwards to whole pixels: the narrow phase truncates
+// positions to ints in places, so it can report a hit up to a pixel past the
+// exact float bounds.
+Aabb CircleCollider::aabb() const {
+    return {std::floor(x) - radius, std::floor(y) - radius,
+            std::ceil(x) + radius, std::ceil(y) + radius};
+}
+
+Aabb RectangleCollider::aabb() const {
+    if (rotation == 0.0f)
+        return {std::floor(x), std::floor(y), std::ceil(x) + width,
+                std::ceil(y) + height};
+    return outline().box;
+}
+
+Aabb PolygonCollider::aabb() const { return outline().box; }
+
+Aabb LineSegmentCollider::aabb() const {
+    auto p2 = getP2();
+    return {std::min<float>(std::floor(x), p2.first),
+            std::min<float>(std::floor(y), p2.second),
+            std::max<float>(std::ceil(x), p2.first),
+            std::max<float>(std::ceil(y), p2.second)};
+}
+
+Aabb PointCollider::aabb() const {
+    return {std::floor(x), std::floor(y), std::ceil(x), std::ceil(y)};
+}
+
+Aabb RegularPolygonCollider::aabb() const {
+    return {std::floor(x - radius), std::floor(y - radius),
+            std::ceil(x + radius), std::ceil(y + radius)};
+}
+
+Aabb MaskCollider::aabb() const {
+    float left = static_cast<int>(x);
+    float top = static_cast<int>(y);
+    return {left, top, left + width - 1, top + height - 1};
+}
+
+// Convex shape as seen by the separating-axis test: a vertex list with its
+// edge normals, or a circle when radius >= 0. Lines and points keep their
+// vertices in the inline storage.
+struct ConvexShape {
+    const std::pair<int, int> *points = nullptr;
+    size_t count = 0;
+    const std::pair<float, float> *normals = nullptr;
+    size_t normalCount = 0;
+    float centerX = 0.0f;
+    float centerY = 0.0f;
+    float radius = -1.0f;
+
+    std::pair<int, int> ends[2];
+    std::pair<float, float> lineNormal;
+};
+
+static void outlineShape(const ColliderOutline &outline, ConvexShape &shape) {
+    shape.points = outline.points.data();
+    shape.count = outline.points.size();
+    shape.normals = outline.normals.data();
+    shape.normalCount = outline.normals.size();
+}
+
+// Returns false for colliders the test cannot handle (concave polygons).
+static bool convexShape(const Collider *collider, ConvexShape &shape) {
+    const ColliderOutline *outline = nullptr;
+    switch (collider->getType()) {
+    case ColliderType::CIRCLE:
+        shape.centerX = collider->x;
+        shape.centerY = collider->y;
+        shape.radius = static_cast<const CircleCollider *>(collider)->radius;
+        return true;
+    case ColliderType::POINT:
+        shape.ends[0] = {(int)collider->x, (int)collider->y};
+        shape.points = shape.ends;
+        shape.count = 1;
+        return true;
+    case ColliderType::LINE: {
+        auto p2 = static_cast<const LineSegmentCollider *>(collider)->getP2();
+        shape.ends[0] = {(int)collider->x, (int)collider->y};
+        shape.ends[1] = p2;
+        shape.points = shape.ends;
+        shape.count = 2;
+        float nx = p2.second - shape.ends[0].second;
+        float ny = shape.ends[0].first - p2.first;
+        float length = std::sqrt(nx * nx + ny * ny);
+        if (length > 0.0f) {
+            shape.lineNormal = {nx / length, ny / length};
+            shape.normals = &shape.lineNormal;
+            shape.normalCount = 1;
+        }
+        return true;
+    }
+    case ColliderType::RECTANGLE:
+        outline = &static_cast<const RectangleCollider *>(collider)->outline();
+        break;
+    case ColliderType::POLYGON:
+        outline = &static_cast<const PolygonCollider *>(collider)->outline();
+        break;
+    case ColliderType::REGULAR_POLYGON:
+        outline =
+            &static_cast<const RegularPolygonCollider *>(collider)->outline();
+        break;
+    case ColliderType::MASK:
+        break;
+    }
+    if (!outline || !outline->convex)
+        return false;
+    outlineShape(*outline, shape);
+    return true;
+}
+
+static void project(const ConvexShape &shape, float axisX, float axisY,
+                    float &min, float &max) {
+    if (shape.radius >= 0.0f) {
+        float center = shape.centerX * axisX + shape.centerY * axisY;
+        min = center - shape.radius;
+        max = center + shape.radius;
+        return;
+    }
+    min = INFINITY;
+    max = -INFINITY;
+    for (size_t i = 0; i < shape.count; i++) {
+        float d = shape.points[i].first * axisX + shape.points[i].second * axisY;
+        min = std::min(min, d);
+        max = std::max(max, d);
+    }
+}
+
+// Returns false if the axis separates the shapes; otherwise keeps the
+// smallest overlap seen so far, oriented from a towards b. Counts the axes
+// actually tested.
+static bool testAxis(const ConvexShape &a, const ConvexShape &b, float axisX,
+                     float axisY, Contact &best, int &tested) {
+    if (axisX == 0.0f && axisY == 0.0f)
+        return true;
+    tested++;
+    float minA, maxA, minB, maxB;
+    project(a, axisX, axisY, minA, maxA);
+    project(b, axisX, axisY, minB, maxB);
+
+    float forward = maxA - minB;
+    float backward = maxB - minA;
+    if (forward <= 0.0f || backward <= 0.0f)
+        return false;
+    float depth = std::min(forward, backward);
+    if (depth < best.depth) {
+        float sign = forward <= backward ? 1.0f : -1.0f;
+        best = {axisX * sign, axisY * sign, depth};
+    }
+    return true;
+}
 
-        int finalX = static_cast<int>(localX * c + localY * s) + rp->x;
-        int finalY = static_cast<int>(-localX * s + localY * c) + rp->y;
+// Separating-axis test. Candidate axes are the edge normals of both shapes
+// plus, with a circle involved, the axis from its centre to the other
+// circle's centre or to the nearest vertex. Shapes whose vertices collapsed
+// onto a point or line also get the x and y axes. Exits on the first
+// separating axis; touching shapes do not overlap.
+static bool separatingAxis(const ConvexShape &a, const ConvexShape &b,
+                           Contact &best) {
+    best = {0.0f, 0.0f, INFINITY};
+    int tested = 0;
+    for (size_t i = 0; i < a.normalCount; i++) {
+        if (!testAxis(a, b, a.normals[i].first, a.normals[i].second, best,
+                      tested))
+            return false;
+    }
+    for (size_t i = 0; i < b.normalCount; i++) {
+        if (!testAxis(a, b, b.normals[i].first, b.normals[i].second, best,
+                      tested))
+            return false;
+    }
 
-        vertices.push_back({finalX, finalY});
+    if (a.radius >= 0.0f || b.radius >= 0.0f) {
+        float axisX = 1.0f;
+        float axisY = 0.0f;
+        if (a.radius >= 0.0f && b.radius >= 0.0f) {
+            axisX = b.centerX - a.centerX;
+            axisY = b.centerY - a.centerY;
+            if (axisX == 0.0f && axisY == 0.0f)
+                axisX = 1.0f;
+        } else {
+            const ConvexShape &circle = a.radius >= 0.0f ? a : b;
+            const ConvexShape &other = a.radius >= 0.0f ? b : a;
+            float bestDistance = INFINITY;
+            for (size_t i = 0; i < other.count; i++) {
+                float dx = other.points[i].first - circle.centerX;
+                float dy = other.points[i].second - circle.centerY;
+                float distance = dx * dx + dy * dy;
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    axisX = dx;
+                    axisY = dy;
+                }
+            }
+        }
+        float length = std::sqrt(axisX * axisX + axisY * axisY);
+        if (length > 0.0f &&
+            !testAxis(a, b, axisX / length, axisY / length, best, tested))
+            return false;
     }
-    return vertices;
+
+    if (tested < 2 && (!testAxis(a, b, 1.0f, 0.0f, best, tested) ||
+                       !testAxis(a, b, 0.0f, 1.0f, best, tested)))
+        return false;
+    return true;
+}
+
+bool Collider::collide(const Collider *other, Contact *contact) const {
+    if (contact)
+        *contact = Contact();
+    if (!other)
+        return false;
+
+    ConvexShape a, b;
+    bool convex = convexShape(this, a) && convexShape(other, b);
+    // Lines and points against each other have no area to test against.
+    if (!convex || (a.radius < 0.0f && b.radius < 0.0f && a.count <= 2 &&
+                    b.count <= 2))
+        return intersects(other);
+    if ((a.radius < 0.0f && a.count == 0) || (b.radius < 0.0f && b.count == 0))
+        return false;
+
+    Contact result;
+    if (!separatingAxis(a, b, result))
+        return false;
+    if (contact)
+        *contact = result;
+    return true;
 }
 
-bool IntersectionVisitor::checkPolygonVsPolygon(
-    const std::vector<std::pair<int, int>> &p1,
-    const std::vector<std::pair<int, int>> &p2) {
+static bool checkPolygonVsPolygon(const ColliderOutline &o1,
+                                  const ColliderOutline &o2) {
+    if (o1.points.empty() || o2.points.empty())
+        return false;
+    if (o1.convex && o2.convex) {
+        ConvexShape a, b;
+        outlineShape(o1, a);
+        outlineShape(o2, b);
+        Contact unused;
+        return separatingAxis(a, b, unused);
+    }
+
+    const auto &p1 = o1.points;
+    const auto &p2 = o2.points;
     for (const auto &p : p1) {
         if (CollisionMath::pointInPolygon(p.first, p.second, p2))
             return true;
@@ -56,158 +371,49 @@ bool IntersectionVisitor::checkPolygonVsPolygon(
     return false;
 }
 
-bool IntersectionVisitor::visitCircle(const CircleCollider *circle) {
-    switch (other->getType()) {
-    case ColliderType::CIRCLE:
-        return circleCircle(circle, static_cast<const CircleCollider *>(other));
-    case ColliderType::RECTANGLE:
-        return circleRectangle(circle,
-                               static_cast<const RectangleCollider *>(other));
-    case ColliderType::POINT:
-        return circlePoint(circle, static_cast<const PointCollider *>(other));
-    case ColliderType::LINE:
-        return circleLine(circle,
-                          static_cast<const LineSegmentCollider *>(other));
-    case ColliderType::POLYGON:
-        return circlePolygon(circle,
-                             static_cast<const PolygonCollider *>(other));
-    case ColliderType::REGULAR_POLYGON:
-        return circleRegularPolygon(
-            circle, static_cast<const RegularPolygonCollider *>(other));
-    default:
-        return false;
-    }
-}
-
-bool IntersectionVisitor::visitRectangle(const RectangleCollider *rect) {
-    switch (other->getType()) {
-    case ColliderType::CIRCLE:
-        return circleRectangle(static_cast<const CircleCollider *>(other),
-                               rect);
-    case ColliderType::RECTANGLE:
-        return rectangleRectangle(
-            rect, static_cast<const RectangleCollider *>(other));
-    case ColliderType::POINT:
-        return rectanglePoint(rect, static_cast<const PointCollider *>(other));
-    case ColliderType::LINE:
-        return rectangleLine(rect,
-                             static_cast<const LineSegmentCollider *>(other));
-    case ColliderType::POLYGON:
-        return rectanglePolygon(rect,
-                                static_cast<const PolygonCollider *>(other));
-    case ColliderType::REGULAR_POLYGON:
-        return rectangleRegularPolygon(
-            rect, static_cast<const RegularPolygonCollider *>(other));
-    default:
-        return false;
-    }
-}
-
-bool IntersectionVisitor::visitPolygon(const PolygonCollider *polygon) {
-    switch (other->getType()) {
-    case ColliderType::CIRCLE:
-        return circlePolygon(static_cast<const CircleCollider *>(other),
-                             polygon);
-    case ColliderType::RECTANGLE:
-        return rectanglePolygon(static_cast<const RectangleCollider *>(other),
-                                polygon);
-    case ColliderType::POINT:
-        return polygonPoint(polygon, static_cast<const PointCollider *>(other));
-    case ColliderType::LINE:
-        return polygonLine(polygon,
-                           static_cast<const LineSegmentCollider *>(other));
-    case ColliderType::POLYGON:
-        return polygonPolygon(polygon,
-                              static_cast<const PolygonCollider *>(other));
-    case ColliderType::REGULAR_POLYGON:
-        return polygonRegularPolygon(
-            polygon, static_cast<const RegularPolygonCollider *>(other));
-    default:
-        return false;
-    }
-}
-
-bool IntersectionVisitor::visitLine(const LineSegmentCollider *line) {
-    switch (other->getType()) {
-    case ColliderType::CIRCLE:
-        return circleLine(static_cast<const CircleCollider *>(other), line);
-    case ColliderType::RECTANGLE:
-        return rectangleLine(static_cast<const RectangleCollider *>(other),
-                             line);
-    case ColliderType::POINT:
-        return linePoint(line, static_cast<const PointCollider *>(other));
-    case ColliderType::LINE:
-        return lineLine(line, static_cast<const LineSegmentCollider *>(other));
-    case ColliderType::POLYGON:
-        return polygonLine(static_cast<const PolygonCollider *>(other), line);
-    case ColliderType::REGULAR_POLYGON:
-        return lineRegularPolygon(
-            line, static_cast<const RegularPolygonCollider *>(other));
-    default:
-        return false;
+static bool circleSegment(const CircleCollider *circle, float x1, float y1,
+                          int x2, int y2) {
+    float lineLenSq = std::pow(x2 - x1, 2) + std::pow(y2 - y1, 2);
+    if (lineLenSq == 0) {
+        return CollisionMath::distanceSquared(circle->x, circle->y,
+                                              static_cast<int>(x1),
+                                              static_cast<int>(y1)) <=
+               (circle->radius * circle->radius);
     }
+    float t = std::max(
+        0.0f, std::min(1.0f, ((circle->x - x1) * (x2 - x1) +
+                              (circle->y - y1) * (y2 - y1)) /
+                                 lineLenSq));
+    float closestX = x1 + t * (x2 - x1);
+    float closestY = y1 + t * (y2 - y1);
+    return CollisionMath::distanceSquared(circle->x, circle->y, closestX,
+                                          closestY) <
+           (circle->radius * circle->radius);
 }
 
-bool IntersectionVisitor::visitPoint(const PointCollider *point) {
-    switch (other->getType()) {
-    case ColliderType::CIRCLE:
-        return circlePoint(static_cast<const CircleCollider *>(other), point);
-    case ColliderType::RECTANGLE:
-        return rectanglePoint(static_cast<const RectangleCollider *>(other),
-                              point);
-    case ColliderType::POINT:
-        return pointPoint(point, static_cast<const PointCollider *>(other));
-    case ColliderType::LINE:
-        return linePoint(static_cast<const LineSegmentCollider *>(other),
-                         point);
-    case ColliderType::POLYGON:
-        return polygonPoint(static_cast<const PolygonCollider *>(other), point);
-    case ColliderType::REGULAR_POLYGON:
-        return pointRegularPolygon(
-            point, static_cast<const RegularPolygonCollider *>(other));
-    default:
-        return false;
-    }
-}
+// Circle against a closed outline: centre inside, or any edge within reach.
+static bool circleOutline(const CircleCollider *circle,
+                          const std::vector<std::pair<int, int>> &points) {
+    if (CollisionMath::pointInPolygon(circle->x, circle->y, points))
+        return true;
 
-bool IntersectionVisitor::visitRegularPolygon(
-    const RegularPolygonCollider *rp) {
-    switch (other->getType()) {
-    case ColliderType::CIRCLE:
-        return circleRegularPolygon(static_cast<const CircleCollider *>(other),
-                                    rp);
-    case ColliderType::RECTANGLE:
-        return rectangleRegularPolygon(
-            static_cast<const RectangleCollider *>(other), rp);
-    case ColliderType::POLYGON:
-        return polygonRegularPolygon(
-            static_cast<const PolygonCollider *>(other), rp);
-    case ColliderType::LINE:
-        return lineRegularPolygon(
-            static_cast<const LineSegmentCollider *>(other), rp);
-    case ColliderType::POINT:
-        return pointRegularPolygon(static_cast<const PointCollider *>(other),
-                                   rp);
-    case ColliderType::REGULAR_POLYGON: {
-        auto p1 = getRegularPolyVertices(rp);
-        auto p2 = getRegularPolyVertices(
-            static_cast<const RegularPolygonCollider *>(other));
-        return checkPolygonVsPolygon(p1, p2);
-    }
-    default:
-        return false;
+    for (size_t i = 0; i < points.size(); i++) {
+        size_t j = (i + 1) % points.size();
+        if (circleSegment(circle, points[i].first, points[i].second,
+                          points[j].first, points[j].second))
+            return true;
     }
+    return false;
 }
 
-bool IntersectionVisitor::circleCircle(const CircleCollider *c1,
-                                       const CircleCollider *c2) {
+static bool circleCircle(const CircleCollider *c1, const CircleCollider *c2) {
     float distSq = CollisionMath::distanceSquared(c1->x, c1->y, c2->x, c2->y);
     float radSum = c1->radius + c2->radius;
     return distSq < radSum * radSum;
 }
 
-bool IntersectionVisitor::circleRectangle(const CircleCollider *circle,
-                                          const RectangleCollider *rect) {
+static bool circleRectangle(const CircleCollider *circle,
+                            const RectangleCollider *rect) {
     if (rect->rotation == 0.0f) {
         // Fast AABB Check
         float testX = circle->x;
@@ -229,109 +435,57 @@ bool IntersectionVisitor::circleRectangle(const CircleCollider *circle,
                (circle->radius * circle->radius);
     } else {
         // Rotated Rectangle -> Treat as Polygon vs Circle
-        auto corners = rect->getCorners();
-        if (CollisionMath::pointInPolygon(circle->x, circle->y, corners))
-            return true;
-
-        for (size_t i = 0; i < corners.size(); i++) {
-            size_t j = (i + 1) % corners.size();
-            LineSegmentCollider line(corners[i].first, corners[i].second,
-                                     corners[j].first, corners[j].second);
-            if (circleLine(circle, &line))
-                return true;
-        }
-        return false;
+        return circleOutline(circle, rect->getCorners());
     }
 }
 
-bool IntersectionVisitor::circlePoint(const CircleCollider *circle,
-                                      const PointCollider *point) {
+static bool circlePoint(const CircleCollider *circle,
+                        const PointCollider *point) {
     return CollisionMath::distanceSquared(circle->x, circle->y, point->x,
                                           point->y) <=
            (circle->radius * circle->radius);
 }
 
-bool IntersectionVisitor::circleLine(const CircleCollider *circle,
-                                     const LineSegmentCollider *line) {
+static bool circleLine(const CircleCollider *circle,
+                       const LineSegmentCollider *line) {
     auto p2 = line->getP2();
-    int x2 = p2.first;
-    int y2 = p2.second;
-
-    float lineLenSq = std::pow(x2 - line->x, 2) + std::pow(y2 - line->y, 2);
-    if (lineLenSq == 0) {
-        PointCollider degenerate(line->x, line->y);
-        return circlePoint(circle, &degenerate);
-    }
-    float t =
-        std::max(0.0f, std::min(1.0f, ((circle->x - line->x) * (x2 - line->x) +
-                                       (circle->y - line->y) * (y2 - line->y)) /
-                                          lineLenSq));
-    float closestX = line->x + t * (x2 - line->x);
-    float closestY = line->y + t * (y2 - line->y);
-    return CollisionMath::distanceSquared(circle->x, circle->y, closestX,
-                                          closestY) <
-           (circle->radius * circle->radius);
+    return circleSegment(circle, line->x, line->y, p2.first, p2.second);
 }
 
-bool IntersectionVisitor::circlePolygon(const CircleCollider *circle,
-                                        const PolygonCollider *polygon) {
-    auto points = polygon->getWorldPoints();
-    if (CollisionMath::pointInPolygon(circle->x, circle->y, points))
-        return true;
-
-    for (size_t i = 0; i < points.size(); i++) {
-        size_t j = (i + 1) % points.size();
-        LineSegmentCollider line(points[i].first, points[i].second,
-                                 points[j].first, points[j].second);
-        if (circleLine(circle, &line))
-            return true;
-    }
-    return false;
+static bool circlePolygon(const CircleCollider *circle,
+                          const PolygonCollider *polygon) {
+    return circleOutline(circle, polygon->getWorldPoints());
 }
 
-bool IntersectionVisitor::circleRegularPolygon(
-    const CircleCollider *circle, const RegularPolygonCollider *rp) {
-    auto points = getRegularPolyVertices(rp);
-
-    if (CollisionMath::pointInPolygon(circle->x, circle->y, points))
-        return true;
-
-    for (size_t i = 0; i < points.size(); i++) {
-        size_t j = (i + 1) % points.size();
-        LineSegmentCollider line(points[i].first, points[i].second,
-                                 points[j].first, points[j].second);
-        if (circleLine(circle, &line))
-            return true;
-    }
-    return false;
+static bool circleRegularPolygon(const CircleCollider *circle,
+                                 const RegularPolygonCollider *rp) {
+    return circleOutline(circle, rp->getVertices());
 }
 
-bool IntersectionVisitor::rectangleRectangle(const RectangleCollider *r1,
-                                             const RectangleCollider *r2) {
+static bool rectangleRectangle(const RectangleCollider *r1,
+                               const RectangleCollider *r2) {
     // Optimization: If BOTH are unrotated, use fast AABB
     if (r1->rotation == 0.0f && r2->rotation == 0.0f) {
         return !(r1->x >= r2->x + r2->width || r1->x + r1->width <= r2->x ||
                  r1->y >= r2->y + r2->height || r1->y + r1->height <= r2->y);
     }
 
-    auto p1 = r1->getCorners();
-    auto p2 = r2->getCorners();
-    return checkPolygonVsPolygon(p1, p2);
+    return checkPolygonVsPolygon(r1->outline(), r2->outline());
 }
 
-bool IntersectionVisitor::rectanglePoint(const RectangleCollider *rect,
-                                         const PointCollider *point) {
+static bool rectanglePoint(const RectangleCollider *rect,
+                           const PointCollider *point) {
     if (rect->rotation == 0.0f) {
         return point->x >= rect->x && point->x <= rect->x + rect->width &&
                point->y >= rect->y && point->y <= rect->y + rect->height;
     }
-    auto corners = rect->getCorners();
+    const auto &corners = rect->getCorners();
     return CollisionMath::pointInPolygon(point->x, point->y, corners);
 }
 
-bool IntersectionVisitor::rectangleLine(const RectangleCollider *rect,
-                                        const LineSegmentCollider *line) {
-    auto corners = rect->getCorners();
+static bool rectangleLine(const RectangleCollider *rect,
+                          const LineSegmentCollider *line) {
+    const auto &corners = rect->getCorners();
     auto p2 = line->getP2();
     int x2 = p2.first;
     int y2 = p2.second;
@@ -349,29 +503,25 @@ bool IntersectionVisitor::rectangleLine(const RectangleCollider *rect,
     return false;
 }
 
-bool IntersectionVisitor::rectanglePolygon(const RectangleCollider *rect,
-                                           const PolygonCollider *polygon) {
-    auto rectPoints = rect->getCorners();
-    auto polyPoints = polygon->getWorldPoints();
-    return checkPolygonVsPolygon(rectPoints, polyPoints);
+static bool rectanglePolygon(const RectangleCollider *rect,
+                             const PolygonCollider *polygon) {
+    return checkPolygonVsPolygon(rect->outline(), polygon->outline());
 }
 
-bool IntersectionVisitor::rectangleRegularPolygon(
-    const RectangleCollider *rect, const RegularPolygonCollider *rp) {
-    auto rectPoints = rect->getCorners();
-    auto polyPoints = getRegularPolyVertices(rp);
-    return checkPolygonVsPolygon(rectPoints, polyPoints);
+static bool rectangleRegularPolygon(const RectangleCollider *rect,
+                                    const RegularPolygonCollider *rp) {
+    return checkPolygonVsPolygon(rect->outline(), rp->outline());
 }
 
-bool IntersectionVisitor::polygonPoint(const PolygonCollider *polygon,
-                                       const PointCollider *point) {
-    auto points = polygon->getWorldPoints();
+static bool polygonPoint(const PolygonCollider *polygon,
+                         const PointCollider *point) {
+    const auto &points = polygon->getWorldPoints();
     return CollisionMath::pointInPolygon(point->x, point->y, points);
 }
 
-bool IntersectionVisitor::polygonLine(const PolygonCollider *polygon,
-                                      const LineSegmentCollider *line) {
-    auto points = polygon->getWorldPoints();
+static bool polygonLine(const PolygonCollider *polygon,
+                        const LineSegmentCollider *line) {
+    const auto &points = polygon->getWorldPoints();
     auto p2 = line->getP2();
     int x2 = p2.first;
     int y2 = p2.second;
@@ -389,22 +539,18 @@ bool IntersectionVisitor::polygonLine(const PolygonCollider *polygon,
     return false;
 }
 
-bool IntersectionVisitor::polygonPolygon(const PolygonCollider *p1,
-                                         const PolygonCollider *p2) {
-    auto pts1 = p1->getWorldPoints();
-    auto pts2 = p2->getWorldPoints();
-    return checkPolygonVsPolygon(pts1, pts2);
+static bool polygonPolygon(const PolygonCollider *p1,
+                           const PolygonCollider *p2) {
+    return checkPolygonVsPolygon(p1->outline(), p2->outline());
 }
 
-bool IntersectionVisitor::polygonRegularPolygon(
-    const PolygonCollider *polygon, const RegularPolygonCollider *rp) {
-    auto pts1 = polygon->getWorldPoints();
-    auto pts2 = getRegularPolyVertices(rp);
-    return checkPolygonVsPolygon(pts1, pts2);
+static bool polygonRegularPolygon(const PolygonCollider *polygon,
+                                  const RegularPolygonCollider *rp) {
+    return checkPolygonVsPolygon(polygon->outline(), rp->outline());
 }
 
-bool IntersectionVisitor::linePoint(const LineSegmentCollider *line,
-                                    const PointCollider *point) {
+static bool linePoint(const LineSegmentCollider *line,
+                      const PointCollider *point) {
     auto p2 = line->getP2();
     int x2 = p2.first;
     int y2 = p2.second;
@@ -418,8 +564,8 @@ bool IntersectionVisitor::linePoint(const LineSegmentCollider *line,
     return std::abs((dist1 + dist2) - lineLen) < 0.5f;
 }
 
-bool IntersectionVisitor::lineLine(const LineSegmentCollider *l1,
-                                   const LineSegmentCollider *l2) {
+static bool lineLine(const LineSegmentCollider *l1,
+                     const LineSegmentCollider *l2) {
     auto p1e = l1->getP2();
     auto p2e = l2->getP2();
     return CollisionMath::lineIntersectLine(l1->x, l1->y, p1e.first, p1e.second,
@@ -427,9 +573,9 @@ bool IntersectionVisitor::lineLine(const LineSegmentCollider *l1,
                                             p2e.second);
 }
 
-bool IntersectionVisitor::lineRegularPolygon(const LineSegmentCollider *line,
-                                             const RegularPolygonCollider *rp) {
-    auto polyPoints = getRegularPolyVertices(rp);
+static bool lineRegularPolygon(const LineSegmentCollider *line,
+                               const RegularPolygonCollider *rp) {
+    const auto &polyPoints = rp->getVertices();
 
     auto p2 = line->getP2();
     int x2 = p2.first;
@@ -449,13 +595,245 @@ bool IntersectionVisitor::lineRegularPolygon(const LineSegmentCollider *line,
     return false;
 }
 
-bool IntersectionVisitor::pointPoint(const PointCollider *p1,
-                                     const PointCollider *p2) {
+static bool pointPoint(const PointCollider *p1, const PointCollider *p2) {
     return p1->x == p2->x && p1->y == p2->y;
 }
 
-bool IntersectionVisitor::pointRegularPolygon(
-    const PointCollider *point, const RegularPolygonCollider *rp) {
-    auto points = getRegularPolyVertices(rp);
+static bool pointRegularPolygon(const PointCollider *point,
+                                const RegularPolygonCollider *rp) {
+    const auto &points = rp->getVertices();
     return CollisionMath::pointInPolygon(point->x, point->y, points);
 }
+
+static bool regularPolygonRegularPolygon(const RegularPolygonCollider *r1,
+                                         const RegularPolygonCollider *r2) {
+    return checkPolygonVsPolygon(r1->outline(), r2->outline());
+}
+
+// Mask tests clip the other collider's extent to the mask, in mask-local
+// pixels, and look for solid pixels row by row.
+static bool maskMask(const MaskCollider *a, const MaskCollider *b) {
+    int ax = (int)a->x, ay = (int)a->y;
+    int bx = (int)b->x, by = (int)b->y;
+    int top = std::max(ay, by);
+    int bottom = std::min(ay + a->getHeight(), by + b->getHeight());
+    int left = std::max(ax, bx);
+    int right = std::min(ax + a->getWidth(), bx + b->getWidth());
+    if (top >= bottom || left >= right)
+        return false;
+
+    // Whole words of a against the 64 pixels of b under each; bits outside
+    // either mask read as clear.
+    int firstWord = (left - ax) >> 6;
+    int lastWord = (right - 1 - ax) >> 6;
+    for (int y = top; y < bottom; y++) {
+        for (int w = firstWord; w <= lastWord; w++) {
+            int column = w * 64;
+            if (a->bitsAt(y - ay, column) &
+                b->bitsAt(y - by, column + ax - bx))
+                return true;
+        }
+    }
+    return false;
+}
+
+static bool maskPoint(const MaskCollider *mask, const PointCollider *point) {
+    return mask->solid((int)point->x - (int)mask->x,
+                       (int)point->y - (int)mask->y);
+}
+
+static bool maskCircle(const MaskCollider *mask,
+                       const CircleCollider *circle) {
+    int cx = (int)circle->x - (int)mask->x;
+    int cy = (int)circle->y - (int)mask->y;
+    int r = circle->radius;
+    int top = std::max(cy - r, 0);
+    int bottom = std::min(cy + r, mask->getHeight() - 1);
+    for (int row = top; row <= bottom; row++) {
+        // Half-width of the circle on this row, as in circlePoint().
+        int rest = r * r - (row - cy) * (row - cy);
+        int reach = static_cast<int>(std::sqrt(static_cast<float>(rest)));
+        while (reach * reach > rest)
+            reach--;
+        while ((reach + 1) * (reach + 1) <= rest)
+            reach++;
+        if (mask->anySolid(row, cx - reach, cx + reach))
+            return true;
+    }
+    return false;
+}
+
+// Solid pixels inside `box`, each tested as a point against `other`.
+static bool maskProbe(const MaskCollider *mask, const Collider *other,
+                      const Aabb &box) {
+    if (!box.overlaps(mask->aabb()))
+        return false;
+    int mx = (int)mask->x, my = (int)mask->y;
+    int first = std::max((int)std::floor(box.minX) - mx, 0);
+    int last = std::min((int)std::ceil(box.maxX) - mx, mask->getWidth() - 1);
+    int top = (int)std::floor(box.minY) - my;
+    int bottom = (int)std::ceil(box.maxY) - my;
+
+    PointCollider probe(0, 0);
+    return mask->forEachRun(top, bottom, [&](int row, int runFirst,
+                                             int runLast) {
+        int end = std::min(runLast, last);
+        for (int column = std::max(runFirst, first); column <= end;
+             column++) {
+            probe.x = mx + column;
+            probe.y = my + row;
+            if (probe.intersects(other))
+                return true;
+        }
+        return false;
+    });
+}
+
+static bool maskRectangle(const MaskCollider *mask,
+                          const RectangleCollider *rect) {
+    if (rect->rotation != 0.0f)
+        return maskProbe(mask, rect, rect->aabb());
+    // Pixels on the edges count, as in rectanglePoint().
+    int mx = (int)mask->x, my = (int)mask->y;
+    int first = (int)std::ceil(rect->x) - mx;
+    int last = (int)std::floor(rect->x + rect->width) - mx;
+    int top = std::max((int)std::ceil(rect->y) - my, 0);
+    int bottom = std::min((int)std::floor(rect->y + rect->height) - my,
+                          mask->getHeight() - 1);
+    for (int row = top; row <= bottom; row++) {
+        if (mask->anySolid(row, first, last))
+            return true;
+    }
+    return false;
+}
+
+static bool maskPolygon(const MaskCollider *mask,
+                        const PolygonCollider *polygon) {
+    return maskProbe(mask, polygon, polygon->aabb());
+}
+
+static bool maskLine(const MaskCollider *mask,
+                     const LineSegmentCollider *line) {
+    // linePoint() accepts points whose path through the ends is up to half
+    // a pixel longer than the line, which reaches sqrt(length + 0.25) / 2
+    // to the side of it.
+    Aabb box = line->aabb();
+    float lengthX = box.maxX - box.minX;
+    float lengthY = box.maxY - box.minY;
+    float reach =
+        std::sqrt(std::sqrt(lengthX * lengthX + lengthY * lengthY) + 0.25f) *
+            0.5f +
+        1.0f;
+    return maskProbe(mask, line,
+                     {box.minX - reach, box.minY - reach, box.maxX + reach,
+                      box.maxY + reach});
+}
+
+static bool maskRegularPolygon(const MaskCollider *mask,
+                               const RegularPolygonCollider *rp) {
+    return maskProbe(mask, rp, rp->aabb());
+}
+
+// Adapts a typed pair test to the table signature; Swapped serves the
+// mirrored cell with the same function.
+template <typename A, typename B, bool (*Test)(const A *, const B *),
+          bool Swapped = false>
+static bool narrow(const Collider *a, const Collider *b) {
+    if constexpr (Swapped)
+        return Test(static_cast<const A *>(b), static_cast<const B *>(a));
+    else
+        return Test(static_cast<const A *>(a), static_cast<const B *>(b));
+}
+
+using NarrowTest = bool (*)(const Collider *, const Collider *);
+using Ci = CircleCollider;
+using Re = RectangleCollider;
+using Po = PolygonCollider;
+using Li = LineSegmentCollider;
+using Pt = PointCollider;
+using Rp = RegularPolygonCollider;
+using Ma = MaskCollider;
+
+static_assert(static_cast<int>(ColliderType::CIRCLE) == 0 &&
+                  static_cast<int>(ColliderType::RECTANGLE) == 1 &&
+                  static_cast<int>(ColliderType::POLYGON) == 2 &&
+                  static_cast<int>(ColliderType::LINE) == 3 &&
+                  static_cast<int>(ColliderType::POINT) == 4 &&
+                  static_cast<int>(ColliderType::REGULAR_POLYGON) == 5 &&
+                  static_cast<int>(ColliderType::MASK) == 6,
+              "narrowTests rows follow ColliderType");
+
+// Pair tests indexed by [first type][second type], resolved at compile
+// time so intersects() is a single indirect call.
+static constexpr NarrowTest narrowTests[ColliderTypeCount][ColliderTypeCount] =
+    {
+        {narrow<Ci, Ci, circleCircle>, narrow<Ci, Re, circleRectangle>,
+         narrow<Ci, Po, circlePolygon>, narrow<Ci, Li, circleLine>,
+         narrow<Ci, Pt, circlePoint>, narrow<Ci, Rp, circleRegularPolygon>,
+         narrow<Ma, Ci, maskCircle, true>},
+        {narrow<Ci, Re, circleRectangle, true>,
+         narrow<Re, Re, rectangleRectangle>,
+         narrow<Re, Po, rectanglePolygon>, narrow<Re, Li, rectangleLine>,
+         narrow<Re, Pt, rectanglePoint>,
+         narrow<Re, Rp, rectangleRegularPolygon>,
+         narrow<Ma, Re, maskRectangle, true>},
+        {narrow<Ci, Po, circlePolygon, true>,
+         narrow<Re, Po, rectanglePolygon, true>,
+         narrow<Po, Po, polygonPolygon>, narrow<Po, Li, polygonLine>,
+         narrow<Po, Pt, polygonPoint>, narrow<Po, Rp, polygonRegularPolygon>,
+         narrow<Ma, Po, maskPolygon, true>},
+        {narrow<Ci, Li, circleLine, true>, narrow<Re, Li, rectangleLine, true>,
+         narrow<Po, Li, polygonLine, true>, narrow<Li, Li, lineLine>,
+         narrow<Li, Pt, linePoint>, narrow<Li, Rp, lineRegularPolygon>,
+         narrow<Ma, Li, maskLine, true>},
+        {narrow<Ci, Pt, circlePoint, true>,
+         narrow<Re, Pt, rectanglePoint, true>,
+         narrow<Po, Pt, polygonPoint, true>, narrow<Li, Pt, linePoint, true>,
+         narrow<Pt, Pt, pointPoint>, narrow<Pt, Rp, pointRegularPolygon>,
+         narrow<Ma, Pt, maskPoint, true>},
+        {narrow<Ci, Rp, circleRegularPolygon, true>,
+         narrow<Re, Rp, rectangleRegularPolygon, true>,
+         narrow<Po, Rp, polygonRegularPolygon, true>,
+         narrow<Li, Rp, lineRegularPolygon, true>,
+         narrow<Pt, Rp, pointRegularPolygon, true>,
+         narrow<Rp, Rp, regularPolygonRegularPolygon>,
+         narrow<Ma, Rp, maskRegularPolygon, true>},
+        {narrow<Ma, Ci, maskCircle>, narrow<Ma, Re, maskRectangle>,
+         narrow<Ma, Po, maskPolygon>, narrow<Ma, Li, maskLine>,
+         narrow<Ma, Pt, maskPoint>, narrow<Ma, Rp, maskRegularPolygon>,
+         narrow<Ma, Ma, maskMask>},
+};
+
+bool Collider::intersects(const Collider *other) const {
+    return narrowTests[static_cast<int>(_type)]
+                      [static_cast<int>(other->_type)](this, other);
+}
+
+bool IntersectionVisitor::visitCircle(const CircleCollider *circle) {
+    return circle->intersects(other);
+}
+
+bool IntersectionVisitor::visitRectangle(const RectangleCollider *rect) {
+    return rect->intersects(other);
+}
+
+bool IntersectionVisitor::visitPolygon(const PolygonCollider *polygon) {
+    return polygon->intersects(other);
+}
+
+bool IntersectionVisitor::visitLine(const LineSegmentCollider *line) {
+    return line->intersects(other);
+}
+
+bool IntersectionVisitor::visitPoint(const PointCollider *point) {
+    return point->intersects(other);
+}
+
+bool IntersectionVisitor::visitRegularPolygon(
+    const RegularPolygonCollider *regularPolygon) {
+    return regularPolygon->intersects(other);
+}
+
+bool IntersectionVisitor::visitMask(const MaskCollider *mask) {
+    return mask->intersects(other);
+}
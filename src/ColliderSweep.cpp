@@ -0,0 +1,409 @@
+#include "Collider.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// Swept tests work on the Minkowski sum of mover and target. A circle
+// sweeping against a shape is its centre casting a ray against the shape
+// grown by the radius, which is the union of circles around the vertices and
+// edges pushed out by the radius. A box sweeping against a convex target runs
+// the separating-axis test over time: on every axis the projections overlap
+// during one interval, and the hit is where the last of those intervals
+// begins.
+
+// Earliest contact offered so far; times past 1 are never offered.
+struct EarliestContact {
+    float time = INFINITY;
+    float normalX = 0.0f;
+    float normalY = 0.0f;
+
+    void offer(float t, float nx, float ny) {
+        if (t < time) {
+            time = t;
+            normalX = nx;
+            normalY = ny;
+        }
+    }
+
+    bool report(SweepHit *hit) const {
+        if (time > 1.0f)
+            return false;
+        if (hit)
+            *hit = {time, normalX, normalY};
+        return true;
+    }
+};
+
+// Normal for a mover that starts inside its target: straight back along the
+// motion, or zero if it does not move.
+static std::pair<float, float> backwards(float dx, float dy) {
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length == 0.0f)
+        return {0.0f, 0.0f};
+    return {-dx / length, -dy / length};
+}
+
+template <typename Point>
+static bool contains(float x, float y, const Point *points, size_t count) {
+    bool inside = false;
+    for (size_t i = 0, j = count - 1; i < count; j = i++) {
+        float xi = points[i].first, yi = points[i].second;
+        float xj = points[j].first, yj = points[j].second;
+        if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi)
+            inside = !inside;
+    }
+    return inside;
+}
+
+// Ray (px, py) + t * (dx, dy) against the circle of radius r around
+// (cx, cy).
+static void castCircle(float px, float py, float dx, float dy, float cx,
+                       float cy, float r, EarliestContact &best) {
+    float fx = px - cx;
+    float fy = py - cy;
+    float c = fx * fx + fy * fy - r * r;
+    if (c < 0.0f) {
+        float length = std::sqrt(fx * fx + fy * fy);
+        auto normal = length > 0.0f
+                          ? std::make_pair(fx / length, fy / length)
+                          : backwards(dx, dy);
+        best.offer(0.0f, normal.first, normal.second);
+        return;
+    }
+
+    float a = dx * dx + dy * dy;
+    float b = fx * dx + fy * dy;
+    if (a == 0.0f || b >= 0.0f)
+        return;
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f)
+        return;
+    float t = std::max((-b - std::sqrt(discriminant)) / a, 0.0f);
+    if (t > 1.0f)
+        return;
+
+    float hx = fx + dx * t;
+    float hy = fy + dy * t;
+    float length = std::sqrt(hx * hx + hy * hy);
+    auto normal = length > 0.0f ? std::make_pair(hx / length, hy / length)
+                                : backwards(dx, dy);
+    best.offer(t, normal.first, normal.second);
+}
+
+// Ray against the edge (ax, ay)-(bx, by) pushed out by r on the side the ray
+// starts from. The rounded ends are left to castCircle() on the vertices.
+static void castEdge(float px, float py, float dx, float dy, float ax,
+                     float ay, float bx, float by, float r,
+                     EarliestContact &best) {
+    float ex = bx - ax;
+    float ey = by - ay;
+    float lengthSquared = ex * ex + ey * ey;
+    if (lengthSquared == 0.0f)
+        return;
+    float length = std::sqrt(lengthSquared);
+    float nx = ey / length;
+    float ny = -ex / length;
+
+    float distance = (px - ax) * nx + (py - ay) * ny;
+    if (distance < 0.0f) {
+        nx = -nx;
+        ny = -ny;
+        distance = -distance;
+    }
+    float along = ((px - ax) * ex + (py - ay) * ey) / lengthSquared;
+    if (distance < r) {
+        if (along >= 0.0f && along <= 1.0f)
+            best.offer(0.0f, nx, ny);
+        return;
+    }
+
+    float speed = dx * nx + dy * ny;
+    if (speed >= 0.0f)
+        return;
+    float t = (distance - r) / -speed;
+    if (t > 1.0f)
+        return;
+    along += t * (dx * ex + dy * ey) / lengthSquared;
+    if (along >= 0.0f && along <= 1.0f)
+        best.offer(t, nx, ny);
+}
+
+// Circle of radius r against a closed polygon.
+template <typename Point>
+static void castPolygon(float px, float py, float dx, float dy, float r,
+                        const Point *points, size_t count,
+                        EarliestContact &best) {
+    if (count == 0)
+        return;
+    if (count >= 3 && contains(px, py, points, count)) {
+        auto normal = backwards(dx, dy);
+        best.offer(0.0f, normal.first, normal.second);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const Point &a = points[i];
+        const Point &b = points[(i + 1) % count];
+        castEdge(px, py, dx, dy, a.first, a.second, b.first, b.second, r,
+                 best);
+        castCircle(px, py, dx, dy, a.first, a.second, r, best);
+    }
+}
+
+// Calls fn(left, right, y) for the runs of solid mask pixels in rows
+// [minY, maxY], as world-space horizontal segments between pixel centres.
+template <typename Fn>
+static void forEachMaskRun(const MaskCollider *mask, float minY, float maxY,
+                           Fn &&fn) {
+    int mx = (int)mask->x, my = (int)mask->y;
+    mask->forEachRun((int)std::floor(minY) - my, (int)std::ceil(maxY) - my,
+                     [&](int row, int first, int last) {
+                         fn(static_cast<float>(mx + first),
+                            static_cast<float>(mx + last),
+                            static_cast<float>(my + row));
+                         return false;
+                     });
+}
+
+static void sweepCircle(float x, float y, float r, float dx, float dy,
+                        const Collider *target, EarliestContact &best) {
+    switch (target->getType()) {
+    case ColliderType::CIRCLE:
+        castCircle(x, y, dx, dy, target->x, target->y,
+                   r + static_cast<const CircleCollider *>(target)->radius,
+                   best);
+        break;
+    case ColliderType::POINT:
+        castCircle(x, y, dx, dy, target->x, target->y, r, best);
+        break;
+    case ColliderType::LINE: {
+        auto p2 = static_cast<const LineSegmentCollider *>(target)->getP2();
+        castEdge(x, y, dx, dy, target->x, target->y, p2.first, p2.second, r,
+                 best);
+        castCircle(x, y, dx, dy, target->x, target->y, r, best);
+        castCircle(x, y, dx, dy, p2.first, p2.second, r, best);
+        break;
+    }
+    case ColliderType::RECTANGLE: {
+        const auto &points =
+            static_cast<const RectangleCollider *>(target)->getCorners();
+        castPolygon(x, y, dx, dy, r, points.data(), points.size(), best);
+        break;
+    }
+    case ColliderType::POLYGON: {
+        const auto &points =
+            static_cast<const PolygonCollider *>(target)->getWorldPoints();
+        castPolygon(x, y, dx, dy, r, points.data(), points.size(), best);
+        break;
+    }
+    case ColliderType::REGULAR_POLYGON: {
+        const auto &points =
+            static_cast<const RegularPolygonCollider *>(target)->getVertices();
+        castPolygon(x, y, dx, dy, r, points.data(), points.size(), best);
+        break;
+    }
+    case ColliderType::MASK:
+        forEachMaskRun(static_cast<const MaskCollider *>(target),
+                       std::min(y, y + dy) - r, std::max(y, y + dy) + r,
+                       [&](float left, float right, float row) {
+                           castEdge(x, y, dx, dy, left, row, right, row, r,
+                                    best);
+                           castCircle(x, y, dx, dy, left, row, r, best);
+                           castCircle(x, y, dx, dy, right, row, r, best);
+                       });
+        break;
+    }
+}
+
+// Projection overlap, in pixels, below which a box only touches its target.
+static constexpr float Slop = 1e-3f;
+
+// Box against a convex point set (a closed polygon, or a segment when
+// count is 2). Axes are the box axes and the edge normals of the target.
+template <typename Point>
+static void sweepBoxConvex(const Aabb &box, float dx, float dy,
+                           const Point *points, size_t count,
+                           EarliestContact &best) {
+    float enter = -INFINITY;
+    float exit = INFINITY;
+    float normalX = 0.0f;
+    float normalY = 0.0f;
+
+    // Narrows [enter, exit]; false once the pair is apart for the whole
+    // motion.
+    auto testAxis = [&](float ax, float ay) {
+        // Projected like the target points, so shared corners compare equal.
+        float boxMin = std::min(box.minX * ax, box.maxX * ax) +
+                       std::min(box.minY * ay, box.maxY * ay);
+        float boxMax = std::max(box.minX * ax, box.maxX * ax) +
+                       std::max(box.minY * ay, box.maxY * ay);
+
+        float targetMin = INFINITY;
+        float targetMax = -INFINITY;
+        for (size_t i = 0; i < count; i++) {
+            float p = points[i].first * ax + points[i].second * ay;
+            targetMin = std::min(targetMin, p);
+            targetMax = std::max(targetMax, p);
+        }
+
+        float speed = dx * ax + dy * ay;
+        if (speed == 0.0f)
+            return boxMax > targetMin && targetMax > boxMin;
+
+        // A pair has to press in by more than rounding error before it
+        // counts as overlapping; otherwise one sliding off a shared vertex
+        // reports a hit at time 0.
+        float axisEnter, axisExit;
+        if (speed > 0.0f) {
+            axisEnter = (targetMin - boxMax) / speed;
+            axisExit = (targetMax - boxMin - Slop) / speed;
+        } else {
+            axisEnter = (targetMax - boxMin) / speed;
+            axisExit = (targetMin - boxMax + Slop) / speed;
+        }
+        if (axisEnter > enter) {
+            enter = axisEnter;
+            normalX = speed > 0.0f ? -ax : ax;
+            normalY = speed > 0.0f ? -ay : ay;
+        }
+        exit = std::min(exit, axisExit);
+        return enter < exit;
+    };
+
+    if (!testAxis(1.0f, 0.0f) || !testAxis(0.0f, 1.0f))
+        return;
+    size_t edges = count == 2 ? 1 : count;
+    for (size_t i = 0; i < edges; i++) {
+        const Point &a = points[i];
+        const Point &b = points[(i + 1) % count];
+        float nx = static_cast<float>(b.second - a.second);
+        float ny = static_cast<float>(a.first - b.first);
+        float length = std::sqrt(nx * nx + ny * ny);
+        if (length > 0.0f && !testAxis(nx / length, ny / length))
+            return;
+    }
+
+    if (exit <= 0.0f || enter > 1.0f)
+        return;
+    best.offer(std::max(enter, 0.0f), normalX, normalY);
+}
+
+// Polygons that are not convex are swept edge by edge.
+template <typename Point>
+static void sweepBoxPolygon(const Aabb &box, float dx, float dy,
+                            const std::vector<Point> &points, bool convex,
+                            EarliestContact &best) {
+    if (convex || points.size() < 3) {
+        sweepBoxConvex(box, dx, dy, points.data(), points.size(), best);
+        return;
+    }
+    if (contains((box.minX + box.maxX) * 0.5f, (box.minY + box.maxY) * 0.5f,
+                 points.data(), points.size())) {
+        auto normal = backwards(dx, dy);
+        best.offer(0.0f, normal.first, normal.second);
+        return;
+    }
+    for (size_t i = 0; i < points.size(); i++) {
+        Point edge[2] = {points[i], points[(i + 1) % points.size()]};
+        sweepBoxConvex(box, dx, dy, edge, 2, best);
+    }
+}
+
+// Unlike aabb(), not rounded to whole pixels.
+static Aabb exactBox(const RectangleCollider *rect) {
+    if (rect->rotation != 0.0f)
+        return rect->aabb();
+    return {rect->x, rect->y, rect->x + rect->width, rect->y + rect->height};
+}
+
+static void sweepBox(const Aabb &box, float dx, float dy,
+                     const Collider *target, EarliestContact &best) {
+    switch (target->getType()) {
+    case ColliderType::CIRCLE:
+    case ColliderType::POINT: {
+        // The same contact seen from the circle, moving the other way.
+        float r = target->getType() == ColliderType::CIRCLE
+                      ? static_cast<const CircleCollider *>(target)->radius
+                      : 0.0f;
+        std::pair<float, float> corners[4] = {{box.minX, box.minY},
+                                              {box.maxX, box.minY},
+                                              {box.maxX, box.maxY},
+                                              {box.minX, box.maxY}};
+        EarliestContact reversed;
+        castPolygon(target->x, target->y, -dx, -dy, r, corners, 4, reversed);
+        if (reversed.time <= 1.0f)
+            best.offer(reversed.time, -reversed.normalX, -reversed.normalY);
+        break;
+    }
+    case ColliderType::LINE: {
+        auto p2 = static_cast<const LineSegmentCollider *>(target)->getP2();
+        std::pair<float, float> segment[2] = {{target->x, target->y},
+                                              {p2.first, p2.second}};
+        sweepBoxConvex(box, dx, dy, segment, 2, best);
+        break;
+    }
+    case ColliderType::RECTANGLE: {
+        auto rect = static_cast<const RectangleCollider *>(target);
+        if (rect->rotation == 0.0f) {
+            Aabb other = exactBox(rect);
+            std::pair<float, float> corners[4] = {{other.minX, other.minY},
+                                                  {other.maxX, other.minY},
+                                                  {other.maxX, other.maxY},
+                                                  {other.minX, other.maxY}};
+            sweepBoxConvex(box, dx, dy, corners, 4, best);
+        } else {
+            const auto &points = rect->getCorners();
+            sweepBoxConvex(box, dx, dy, points.data(), points.size(), best);
+        }
+        break;
+    }
+    case ColliderType::POLYGON: {
+        const ColliderOutline &outline =
+            static_cast<const PolygonCollider *>(target)->outline();
+        sweepBoxPolygon(box, dx, dy, outline.points, outline.convex, best);
+        break;
+    }
+    case ColliderType::REGULAR_POLYGON: {
+        const ColliderOutline &outline =
+            static_cast<const RegularPolygonCollider *>(target)->outline();
+        sweepBoxPolygon(box, dx, dy, outline.points, outline.convex, best);
+        break;
+    }
+    case ColliderType::MASK:
+        forEachMaskRun(static_cast<const MaskCollider *>(target),
+                       box.minY + std::min(dy, 0.0f),
+                       box.maxY + std::max(dy, 0.0f),
+                       [&](float left, float right, float row) {
+                           std::pair<float, float> run[2] = {{left, row},
+                                                             {right, row}};
+                           sweepBoxConvex(box, dx, dy, run, 2, best);
+                       });
+        break;
+    }
+}
+
+bool CircleCollider::sweep(float dx, float dy, const Collider *target,
+                           SweepHit *hit) const {
+    if (!target)
+        return false;
+    EarliestContact best;
+    sweepCircle(x, y, radius, dx, dy, target, best);
+    return best.report(hit);
+}
+
+bool PointCollider::sweep(float dx, float dy, const Collider *target,
+                          SweepHit *hit) const {
+    if (!target)
+        return false;
+    EarliestContact best;
+    sweepCircle(x, y, 0.0f, dx, dy, target, best);
+    return best.report(hit);
+}
+
+bool RectangleCollider::sweep(float dx, float dy, const Collider *target,
+                              SweepHit *hit) const {
+    if (!target)
+        return false;
+    EarliestContact best;
+    sweepBox(exactBox(this), dx, dy, target, best);
+    return best.report(hit);
+}
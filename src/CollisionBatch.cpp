@@ -0,0 +1,220 @@
+#include "CollisionBatch.hpp"
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Appends a hit for every set bit of `mask`, lanes starting at `base`.
+static inline void emitHits(uint32_t first, uint32_t base, unsigned mask,
+                            std::vector<BatchHit> &hits) {
+    while (mask) {
+        hits.push_back({first, base + __builtin_ctz(mask)});
+        mask &= mask - 1;
+    }
+}
+
+static inline bool circleCircle(float ax, float ay, float ar, float bx,
+                                float by, float br) {
+    float dx = ax - bx;
+    float dy = ay - by;
+    float reach = ar + br;
+    float dist = dx * dx + dy * dy;
+    // Inclusive against points, as circlePoint() and pointPoint() are.
+    if (ar == 0.0f || br == 0.0f)
+        return dist <= reach * reach;
+    return dist < reach * reach;
+}
+
+static inline bool circleBox(float cx, float cy, float r, float minX,
+                             float minY, float maxX, float maxY) {
+    float dx = cx - std::min(std::max(cx, minX), maxX);
+    float dy = cy - std::min(std::max(cy, minY), maxY);
+    return dx * dx + dy * dy <= r * r;
+}
+
+static inline bool boxBox(float aMinX, float aMinY, float aMaxX, float aMaxY,
+                          float bMinX, float bMinY, float bMaxX, float bMaxY) {
+    return aMinX < bMaxX && bMinX < aMaxX && aMinY < bMaxY && bMinY < aMaxY;
+}
+
+void batchCircleCircle(const CircleBatch &a, const CircleBatch &b,
+                       std::vector<BatchHit> &hits) {
+    const uint32_t count = b.size();
+    const float *bx = b.x.data();
+    const float *by = b.y.data();
+    const float *br = b.radius.data();
+
+    for (uint32_t i = 0; i < a.size(); i++) {
+        const float ax = a.x[i], ay = a.y[i], ar = a.radius[i];
+        uint32_t j = 0;
+
+#if defined(__AVX2__)
+        {
+            const __m256 x = _mm256_set1_ps(ax), y = _mm256_set1_ps(ay),
+                         r = _mm256_set1_ps(ar), zero = _mm256_setzero_ps();
+            for (; j + 8 <= count; j += 8) {
+                __m256 radius = _mm256_loadu_ps(br + j);
+                __m256 dx = _mm256_sub_ps(x, _mm256_loadu_ps(bx + j));
+                __m256 dy = _mm256_sub_ps(y, _mm256_loadu_ps(by + j));
+                __m256 reach = _mm256_add_ps(r, radius);
+                __m256 dist = _mm256_add_ps(_mm256_mul_ps(dx, dx),
+                                            _mm256_mul_ps(dy, dy));
+                reach = _mm256_mul_ps(reach, reach);
+                __m256 point = _mm256_cmp_ps(_mm256_min_ps(r, radius), zero,
+                                             _CMP_EQ_OQ);
+                __m256 hit = _mm256_or_ps(
+                    _mm256_cmp_ps(dist, reach, _CMP_LT_OQ),
+                    _mm256_and_ps(point,
+                                  _mm256_cmp_ps(dist, reach, _CMP_LE_OQ)));
+                emitHits(i, j, _mm256_movemask_ps(hit), hits);
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        {
+            const __m128 x = _mm_set1_ps(ax), y = _mm_set1_ps(ay),
+                         r = _mm_set1_ps(ar), zero = _mm_setzero_ps();
+            for (; j + 4 <= count; j += 4) {
+                __m128 radius = _mm_loadu_ps(br + j);
+                __m128 dx = _mm_sub_ps(x, _mm_loadu_ps(bx + j));
+                __m128 dy = _mm_sub_ps(y, _mm_loadu_ps(by + j));
+                __m128 reach = _mm_add_ps(r, radius);
+                __m128 dist =
+                    _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                reach = _mm_mul_ps(reach, reach);
+                __m128 point = _mm_cmpeq_ps(_mm_min_ps(r, radius), zero);
+                __m128 hit = _mm_or_ps(
+                    _mm_cmplt_ps(dist, reach),
+                    _mm_and_ps(point, _mm_cmple_ps(dist, reach)));
+                emitHits(i, j, _mm_movemask_ps(hit), hits);
+            }
+        }
+#endif
+
+        for (; j < count; j++) {
+            if (circleCircle(ax, ay, ar, bx[j], by[j], br[j]))
+                hits.push_back({i, j});
+        }
+    }
+}
+
+void batchCircleBox(const CircleBatch &circles, const BoxBatch &boxes,
+                    std::vector<BatchHit> &hits) {
+    const uint32_t count = boxes.size();
+    const float *minX = boxes.minX.data();
+    const float *minY = boxes.minY.data();
+    const float *maxX = boxes.maxX.data();
+    const float *maxY = boxes.maxY.data();
+
+    for (uint32_t i = 0; i < circles.size(); i++) {
+        const float cx = circles.x[i], cy = circles.y[i],
+                    r = circles.radius[i];
+        uint32_t j = 0;
+
+#if defined(__AVX2__)
+        {
+            const __m256 x = _mm256_set1_ps(cx), y = _mm256_set1_ps(cy),
+                         r2 = _mm256_set1_ps(r * r);
+            for (; j + 8 <= count; j += 8) {
+                __m256 nearX = _mm256_min_ps(
+                    _mm256_max_ps(x, _mm256_loadu_ps(minX + j)),
+                    _mm256_loadu_ps(maxX + j));
+                __m256 nearY = _mm256_min_ps(
+                    _mm256_max_ps(y, _mm256_loadu_ps(minY + j)),
+                    _mm256_loadu_ps(maxY + j));
+                __m256 dx = _mm256_sub_ps(x, nearX);
+                __m256 dy = _mm256_sub_ps(y, nearY);
+                __m256 dist = _mm256_add_ps(_mm256_mul_ps(dx, dx),
+                                            _mm256_mul_ps(dy, dy));
+                __m256 hit = _mm256_cmp_ps(dist, r2, _CMP_LE_OQ);
+                emitHits(i, j, _mm256_movemask_ps(hit), hits);
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        {
+            const __m128 x = _mm_set1_ps(cx), y = _mm_set1_ps(cy),
+                         r2 = _mm_set1_ps(r * r);
+            for (; j + 4 <= count; j += 4) {
+                __m128 nearX = _mm_min_ps(_mm_max_ps(x, _mm_loadu_ps(minX + j)),
+                                          _mm_loadu_ps(maxX + j));
+                __m128 nearY = _mm_min_ps(_mm_max_ps(y, _mm_loadu_ps(minY + j)),
+                                          _mm_loadu_ps(maxY + j));
+                __m128 dx = _mm_sub_ps(x, nearX);
+                __m128 dy = _mm_sub_ps(y, nearY);
+                __m128 dist =
+                    _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                __m128 hit = _mm_cmple_ps(dist, r2);
+                emitHits(i, j, _mm_movemask_ps(hit), hits);
+            }
+        }
+#endif
+
+        for (; j < count; j++) {
+            if (circleBox(cx, cy, r, minX[j], minY[j], maxX[j], maxY[j]))
+                hits.push_back({i, j});
+        }
+    }
+}
+
+void batchBoxBox(const BoxBatch &a, const BoxBatch &b,
+                 std::vector<BatchHit> &hits) {
+    const uint32_t count = b.size();
+    const float *minX = b.minX.data();
+    const float *minY = b.minY.data();
+    const float *maxX = b.maxX.data();
+    const float *maxY = b.maxY.data();
+
+    for (uint32_t i = 0; i < a.size(); i++) {
+        const float aMinX = a.minX[i], aMinY = a.minY[i], aMaxX = a.maxX[i],
+                    aMaxY = a.maxY[i];
+        uint32_t j = 0;
+
+#if defined(__AVX2__)
+        {
+            const __m256 x0 = _mm256_set1_ps(aMinX),
+                         y0 = _mm256_set1_ps(aMinY),
+                         x1 = _mm256_set1_ps(aMaxX),
+                         y1 = _mm256_set1_ps(aMaxY);
+            for (; j + 8 <= count; j += 8) {
+                __m256 hit = _mm256_and_ps(
+                    _mm256_and_ps(
+                        _mm256_cmp_ps(x0, _mm256_loadu_ps(maxX + j),
+                                      _CMP_LT_OQ),
+                        _mm256_cmp_ps(_mm256_loadu_ps(minX + j), x1,
+                                      _CMP_LT_OQ)),
+                    _mm256_and_ps(
+                        _mm256_cmp_ps(y0, _mm256_loadu_ps(maxY + j),
+                                      _CMP_LT_OQ),
+                        _mm256_cmp_ps(_mm256_loadu_ps(minY + j), y1,
+                                      _CMP_LT_OQ)));
+                emitHits(i, j, _mm256_movemask_ps(hit), hits);
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        {
+            const __m128 x0 = _mm_set1_ps(aMinX), y0 = _mm_set1_ps(aMinY),
+                         x1 = _mm_set1_ps(aMaxX), y1 = _mm_set1_ps(aMaxY);
+            for (; j + 4 <= count; j += 4) {
+                __m128 hit = _mm_and_ps(
+                    _mm_and_ps(_mm_cmplt_ps(x0, _mm_loadu_ps(maxX + j)),
+                               _mm_cmplt_ps(_mm_loadu_ps(minX + j), x1)),
+                    _mm_and_ps(_mm_cmplt_ps(y0, _mm_loadu_ps(maxY + j)),
+                               _mm_cmplt_ps(_mm_loadu_ps(minY + j), y1)));
+                emitHits(i, j, _mm_movemask_ps(hit), hits);
+            }
+        }
+#endif
+
+        for (; j < count; j++) {
+            if (boxBox(aMinX, aMinY, aMaxX, aMaxY, minX[j], minY[j], maxX[j],
+                       maxY[j]))
+                hits.push_back({i, j});
+        }
+    }
+}
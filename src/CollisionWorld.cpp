@@ -0,0 +1,396 @@
+#include "CollisionWorld.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const char *TAG = "CollisionWorld";
+
+CollisionWorld::CollisionWorld(float cellSize, int bucketCount)
+    : inverseCellSize(1.0f / std::max(cellSize, 1.0f)) {
+    uint32_t count = 1;
+    while (count < static_cast<uint32_t>(std::max(bucketCount, 1)))
+        count <<= 1;
+    bucketMask = count - 1;
+    buckets.resize(count);
+}
+
+CollisionWorld::~CollisionWorld() { clear(); }
+
+// Clamped so that empty boxes (infinite bounds) stay representable; an
+// inverted box yields an empty range.
+static int cellCoord(float value, float inverseCellSize) {
+    return static_cast<int>(
+        std::clamp(std::floor(value * inverseCellSize), -1e6f, 1e6f));
+}
+
+CollisionWorld::CellRange CollisionWorld::cellRange(const Aabb &box) const {
+    return {cellCoord(box.minX, inverseCellSize),
+            cellCoord(box.minY, inverseCellSize),
+            cellCoord(box.maxX, inverseCellSize),
+            cellCoord(box.maxY, inverseCellSize)};
+}
+
+std::vector<uint32_t> &CollisionWorld::bucket(int cellX, int cellY) {
+    uint32_t hash = static_cast<uint32_t>(cellX) * 73856093u ^
+                    static_cast<uint32_t>(cellY) * 19349663u;
+    return buckets[hash & bucketMask];
+}
+
+const std::vector<uint32_t> &CollisionWorld::bucket(int cellX,
+                                                    int cellY) const {
+    return const_cast<CollisionWorld *>(this)->bucket(cellX, cellY);
+}
+
+// Several cells can hash to the same bucket; a proxy is stored there once.
+void CollisionWorld::insertCells(uint32_t id) {
+    const CellRange &cells = proxies[id].cells;
+    for (int cy = cells.minY; cy <= cells.maxY; cy++) {
+        for (int cx = cells.minX; cx <= cells.maxX; cx++) {
+            auto &ids = bucket(cx, cy);
+            if (std::find(ids.begin(), ids.end(), id) == ids.end())
+                ids.push_back(id);
+        }
+    }
+}
+
+void CollisionWorld::removeCells(uint32_t id) {
+    const CellRange &cells = proxies[id].cells;
+    for (int cy = cells.minY; cy <= cells.maxY; cy++) {
+        for (int cx = cells.minX; cx <= cells.maxX; cx++) {
+            auto &ids = bucket(cx, cy);
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end()) {
+                *it = ids.back();
+                ids.pop_back();
+            }
+        }
+    }
+}
+
+void CollisionWorld::add(Collider *collider) {
+    if (!collider)
+        return;
+    if (collider->_world) {
+        if (collider->_world != this)
+            RENDERER_LOGW(TAG, "Collider already belongs to another world");
+        return;
+    }
+
+    uint32_t id;
+    if (!freeProxies.empty()) {
+        id = freeProxies.back();
+        freeProxies.pop_back();
+    } else {
+        id = proxies.size();
+        proxies.emplace_back();
+        visitStamps.push_back(0);
+    }
+
+    Aabb box = collider->aabb();
+    proxies[id] = {collider, box, cellRange(box), true};
+    collider->_world = this;
+    collider->_proxy = id;
+    insertCells(id);
+}
+
+void CollisionWorld::remove(Collider *collider) {
+    if (!collider || collider->_world != this)
+        return;
+    uint32_t id = collider->_proxy;
+    removeCells(id);
+    proxies[id].collider = nullptr;
+    freeProxies.push_back(id);
+    // The id is reused by the next add(), so its cached pairs must go.
+    contacts.erase(std::remove_if(contacts.begin(), contacts.end(),
+                                  [id](const CachedPair &pair) {
+                                      return pair.key >> 32 == id ||
+                                             (pair.key & 0xFFFFFFFFu) == id;
+                                  }),
+                   contacts.end());
+    collider->_world = nullptr;
+}
+
+void CollisionWorld::update(Collider *collider) {
+    if (!collider || collider->_world != this)
+        return;
+    uint32_t id = collider->_proxy;
+    Proxy &proxy = proxies[id];
+    proxy.box = collider->aabb();
+    proxy.moved = true;
+
+    CellRange cells = cellRange(proxy.box);
+    if (cells == proxy.cells)
+        return;
+    removeCells(id);
+    proxy.cells = cells;
+    insertCells(id);
+}
+
+void CollisionWorld::clear() {
+    for (Proxy &proxy : proxies) {
+        if (proxy.collider)
+            proxy.collider->_world = nullptr;
+    }
+    for (auto &ids : buckets)
+        ids.clear();
+    proxies.clear();
+    freeProxies.clear();
+    contacts.clear();
+    visitStamps.clear();
+}
+
+const std::vector<ColliderPair> &CollisionWorld::candidatePairs() {
+    pairs.clear();
+    for (uint32_t id = 0; id < proxies.size(); id++) {
+        const Proxy &a = proxies[id];
+        if (!a.collider)
+            continue;
+
+        for (int cy = a.cells.minY; cy <= a.cells.maxY; cy++) {
+            for (int cx = a.cells.minX; cx <= a.cells.maxX; cx++) {
+                for (uint32_t otherId : bucket(cx, cy)) {
+                    if (otherId <= id)
+                        continue;
+                    const Proxy &b = proxies[otherId];
+                    if (!a.box.overlaps(b.box))
+                        continue;
+                    // Report the pair only from the first cell both span.
+                    if (cx != std::max(a.cells.minX, b.cells.minX) ||
+                        cy != std::max(a.cells.minY, b.cells.minY))
+                        continue;
+                    pairs.push_back({a.collider, b.collider});
+                }
+            }
+        }
+    }
+    return pairs;
+}
+
+void CollisionWorld::collidingPairs(std::vector<ColliderPair> &out) {
+    for (const ColliderPair &pair : candidatePairs()) {
+        if (pair.first->intersects(pair.second))
+            out.push_back(pair);
+    }
+}
+
+void CollisionWorld::updateContacts(std::vector<ContactEvent> &events) {
+    nextContacts.clear();
+    for (const ColliderPair &pair : candidatePairs()) {
+        uint64_t a = pair.first->_proxy;
+        uint64_t b = pair.second->_proxy;
+        nextContacts.push_back({std::min(a, b) << 32 | std::max(a, b), false});
+    }
+    std::sort(nextContacts.begin(), nextContacts.end(),
+              [](const CachedPair &l, const CachedPair &r) {
+                  return l.key < r.key;
+              });
+
+    auto collidersOf = [this](uint64_t key) {
+        return std::make_pair(proxies[key >> 32].collider,
+                              proxies[key & 0xFFFFFFFFu].collider);
+    };
+
+    // Both lists are sorted, so one merge pass pairs each candidate with
+    // its previous result and finds the pairs that are no longer
+    // candidates.
+    auto previous = contacts.begin();
+    for (CachedPair &next : nextContacts) {
+        for (; previous != contacts.end() && previous->key < next.key;
+             ++previous) {
+            if (previous->touching) {
+                auto [first, second] = collidersOf(previous->key);
+                events.push_back({first, second, ContactPhase::Exit});
+            }
+        }
+
+        auto [first, second] = collidersOf(next.key);
+        bool known = previous != contacts.end() && previous->key == next.key;
+        bool wasTouching = known && previous->touching;
+        if (known && !proxies[first->_proxy].moved &&
+            !proxies[second->_proxy].moved)
+            next.touching = wasTouching;
+        else
+            next.touching = first->intersects(second);
+
+        if (next.touching)
+            events.push_back({first, second,
+                              wasTouching ? ContactPhase::Stay
+                                          : ContactPhase::Enter});
+        else if (wasTouching)
+            events.push_back({first, second, ContactPhase::Exit});
+        if (known)
+            ++previous;
+    }
+    for (; previous != contacts.end(); ++previous) {
+        if (previous->touching) {
+            auto [first, second] = collidersOf(previous->key);
+            events.push_back({first, second, ContactPhase::Exit});
+        }
+    }
+
+    contacts.swap(nextContacts);
+    for (Proxy &proxy : proxies)
+        proxy.moved = false;
+}
+
+void CollisionWorld::nextVisitStamp() const {
+    if (++visitStamp == 0) {
+        std::fill(visitStamps.begin(), visitStamps.end(), 0);
+        visitStamp = 1;
+    }
+}
+
+template <typename Fn>
+void CollisionWorld::forEachOverlap(const Aabb &area, Fn &&fn) const {
+    nextVisitStamp();
+
+    CellRange cells = cellRange(area);
+    for (int cy = cells.minY; cy <= cells.maxY; cy++) {
+        for (int cx = cells.minX; cx <= cells.maxX; cx++) {
+            for (uint32_t id : bucket(cx, cy)) {
+                if (visitStamps[id] == visitStamp)
+                    continue;
+                visitStamps[id] = visitStamp;
+                if (proxies[id].box.overlaps(area))
+                    fn(proxies[id].collider);
+            }
+        }
+    }
+}
+
+void CollisionWorld::query(const Aabb &area,
+                           std::vector<Collider *> &out) const {
+    forEachOverlap(area, [&](Collider *collider) { out.push_back(collider); });
+}
+
+void CollisionWorld::query(const Collider *collider,
+                           std::vector<Collider *> &out) const {
+    if (!collider)
+        return;
+    forEachOverlap(collider->aabb(), [&](Collider *other) {
+        if (other != collider && collider->intersects(other))
+            out.push_back(other);
+    });
+}
+
+// Grid DDA: tNextX / tNextY are the segment parameters at which it crosses
+// the next vertical / horizontal cell boundary.
+template <typename Fn>
+void CollisionWorld::forEachAlongSegment(float x, float y, float dx, float dy,
+                                         int marginX, int marginY,
+                                         const float &limit, Fn &&fn) const {
+    nextVisitStamp();
+
+    const float cellSize = 1.0f / inverseCellSize;
+    int cellX = cellCoord(x, inverseCellSize);
+    int cellY = cellCoord(y, inverseCellSize);
+    const int endX = cellCoord(x + dx, inverseCellSize);
+    const int endY = cellCoord(y + dy, inverseCellSize);
+    const int stepX = dx > 0.0f ? 1 : -1;
+    const int stepY = dy > 0.0f ? 1 : -1;
+
+    const float tDeltaX = dx != 0.0f ? cellSize / std::fabs(dx) : INFINITY;
+    const float tDeltaY = dy != 0.0f ? cellSize / std::fabs(dy) : INFINITY;
+    float tNextX = dx != 0.0f
+                       ? ((cellX + (dx > 0.0f)) * cellSize - x) / dx
+                       : INFINITY;
+    float tNextY = dy != 0.0f
+                       ? ((cellY + (dy > 0.0f)) * cellSize - y) / dy
+                       : INFINITY;
+
+    float entry = 0.0f;
+    while (entry <= limit) {
+        for (int cy = cellY - marginY; cy <= cellY + marginY; cy++) {
+            for (int cx = cellX - marginX; cx <= cellX + marginX; cx++) {
+                for (uint32_t id : bucket(cx, cy)) {
+                    if (visitStamps[id] == visitStamp)
+                        continue;
+                    visitStamps[id] = visitStamp;
+                    fn(proxies[id]);
+                }
+            }
+        }
+
+        if ((cellX == endX && cellY == endY) || entry > 1.0f)
+            break;
+        if (tNextX < tNextY) {
+            entry = tNextX;
+            tNextX += tDeltaX;
+            cellX += stepX;
+        } else {
+            entry = tNextY;
+            tNextY += tDeltaY;
+            cellY += stepY;
+        }
+    }
+}
+
+static bool sweepShape(const Collider *shape, float dx, float dy,
+                       const Collider *target, SweepHit *hit) {
+    switch (shape->getType()) {
+    case ColliderType::CIRCLE:
+        return static_cast<const CircleCollider *>(shape)->sweep(dx, dy,
+                                                                 target, hit);
+    case ColliderType::POINT:
+        return static_cast<const PointCollider *>(shape)->sweep(dx, dy,
+                                                                target, hit);
+    case ColliderType::RECTANGLE:
+        return static_cast<const RectangleCollider *>(shape)->sweep(
+            dx, dy, target, hit);
+    default:
+        return false;
+    }
+}
+
+bool CollisionWorld::raycast(float x, float y, float dirX, float dirY,
+                             float maxDistance, CastHit *hit) const {
+    PointCollider origin(0, 0);
+    origin.x = x;
+    origin.y = y;
+    return shapeCast(&origin, dirX, dirY, maxDistance, hit);
+}
+
+bool CollisionWorld::shapeCast(const Collider *shape, float dirX, float dirY,
+                               float maxDistance, CastHit *hit) const {
+    float length = std::sqrt(dirX * dirX + dirY * dirY);
+    if (!shape || length == 0.0f || !(maxDistance > 0.0f))
+        return false;
+    float dx = dirX / length * maxDistance;
+    float dy = dirY / length * maxDistance;
+
+    // The walk follows the centre of the shape's box; colliders within its
+    // half extents of a crossed cell can be touched from that cell.
+    Aabb box = shape->aabb();
+    float halfWidth = (box.maxX - box.minX) * 0.5f;
+    float halfHeight = (box.maxY - box.minY) * 0.5f;
+    int marginX = static_cast<int>(std::ceil(halfWidth * inverseCellSize));
+    int marginY = static_cast<int>(std::ceil(halfHeight * inverseCellSize));
+
+    Aabb swept = {std::min(box.minX, box.minX + dx),
+                  std::min(box.minY, box.minY + dy),
+                  std::max(box.maxX, box.maxX + dx),
+                  std::max(box.maxY, box.maxY + dy)};
+
+    float nearest = INFINITY;
+    SweepHit best;
+    Collider *bestCollider = nullptr;
+    forEachAlongSegment(
+        box.minX + halfWidth, box.minY + halfHeight, dx, dy, marginX, marginY,
+        nearest, [&](const Proxy &proxy) {
+            SweepHit sweep;
+            if (proxy.collider == shape || !proxy.box.overlaps(swept) ||
+                !sweepShape(shape, dx, dy, proxy.collider, &sweep) ||
+                sweep.time >= nearest)
+                return;
+            nearest = sweep.time;
+            best = sweep;
+            bestCollider = proxy.collider;
+        });
+
+    if (!bestCollider)
+        return false;
+    if (hit)
+        *hit = {bestCollider, best.time * maxDistance, best.normalX,
+                best.normalY};
+    return true;
+}
@@ -1,5 +1,7 @@
 #include "DrawUtils.hpp"
+#include "PixelPipeline.hpp"
 #include "Shapes/Shape.hpp"
+#include "SpanBlend.hpp"
 #include "Texture.hpp"
 #include <algorithm>
 #include <cmath>
@@ -15,12 +17,9 @@ void transformPoint(int x, int y, const Matrix2D &m, int &outX, int &outY) {
 Color sampleTexture(const PaintCtx &ctx, int x, int y) {
     if (!ctx.texture)
         return ctx.color;
-    float u = ctx.tex_A * x + ctx.tex_B * y + ctx.tex_C;
-    float v = ctx.tex_D * x + ctx.tex_E * y + ctx.tex_F;
-    int texU = static_cast<int>(std::round(u));
-    int texV = static_cast<int>(std::round(v));
-    Color texColor = ctx.texture->sample(texU, texV);
-    texColor.a = (texColor.a * ctx.color.a) >> 8;
+    Color texColor;
+    PixelPipeline::withTexturedPaint(
+        ctx, [&](const auto &paint) { texColor = paint.at(x, y); });
     return texColor;
 }
 
@@ -28,8 +27,12 @@ void addPixel(Display &displayGrid, int x, int y, float alpha,
               const PaintCtx &ctx) {
     if (alpha <= 0.0f)
         return;
-    if (static_cast<unsigned>(x) >= static_cast<unsigned>(displayGrid.width) ||
-        static_cast<unsigned>(y) >= static_cast<unsigned>(displayGrid.height))
+    int localX = x - displayGrid.originX;
+    int localY = y - displayGrid.originY;
+    if (static_cast<unsigned>(localX) >=
+            static_cast<unsigned>(displayGrid.width) ||
+        static_cast<unsigned>(localY) >=
+            static_cast<unsigned>(displayGrid.height))
         return;
 
     uint8_t finalAlpha = static_cast<uint8_t>(alpha * ctx.color.a);
@@ -37,50 +40,54 @@ void addPixel(Display &displayGrid, int x, int y, float alpha,
         return;
     uint32_t invAlpha = 255 - finalAlpha;
 
-    int index = y * displayGrid.width + x;
-    Color *targetPixel = &displayGrid.pixels[index];
+    int index = localY * displayGrid.width + localX;
+    Pixel *targetPixel = &displayGrid.pixels[index];
+    Color target = PixelFormat::load(*targetPixel);
 
     if (!ctx.texture) {
-        targetPixel->r =
-            (ctx.color.r * finalAlpha + targetPixel->r * invAlpha) >> 8;
-        targetPixel->g =
-            (ctx.color.g * finalAlpha + targetPixel->g * invAlpha) >> 8;
-        targetPixel->b =
-            (ctx.color.b * finalAlpha + targetPixel->b * invAlpha) >> 8;
+        target.r = (ctx.color.r * finalAlpha + target.r * invAlpha) >> 8;
+        target.g = (ctx.color.g * finalAlpha + target.g * invAlpha) >> 8;
+        target.b = (ctx.color.b * finalAlpha + target.b * invAlpha) >> 8;
     } else {
         Color texColor = sampleTexture(ctx, x, y);
         uint32_t texAlpha = (finalAlpha * texColor.a) >> 8;
         uint32_t invTexAlpha = 255 - texAlpha;
-        targetPixel->r =
-            (texColor.r * texAlpha + targetPixel->r * invTexAlpha) >> 8;
-        targetPixel->g =
-            (texColor.g * texAlpha + targetPixel->g * invTexAlpha) >> 8;
-        targetPixel->b =
-            (texColor.b * texAlpha + targetPixel->b * invTexAlpha) >> 8;
+        target.r = (texColor.r * texAlpha + target.r * invTexAlpha) >> 8;
+        target.g = (texColor.g * texAlpha + target.g * invTexAlpha) >> 8;
+        target.b = (texColor.b * texAlpha + target.b * invTexAlpha) >> 8;
     }
-    targetPixel->a = 255;
+    *targetPixel = PixelFormat::store(target);
 }
 
 void bresenhamLine(Display &displayGrid, int x0, int y0, int x1, int y1,
                    const PaintCtx &ctx) {
-    int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
-    int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
-    int err = dx + dy, e2;
+    if (ctx.color.a == 0)
+        return;
+    Bounds extent{std::min(x0, x1), std::min(y0, y1), std::max(x0, x1),
+                  std::max(y0, y1)};
+    if (!extent.intersects(displayGrid.bounds()))
+        return;
 
-    while (true) {
-        addPixel(displayGrid, x0, y0, 1.0f, ctx);
-        if (x0 == x1 && y0 == y1)
-            break;
-        e2 = 2 * err;
-        if (e2 >= dy) {
-            err += dy;
-            x0 += sx;
-        }
-        if (e2 <= dx) {
-            err += dx;
-            y0 += sy;
+    PixelPipeline::dispatch(displayGrid, ctx, extent, [&](const auto &writer) {
+        int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+        int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy, e2;
+
+        while (true) {
+            writer.plot(x0, y0);
+            if (x0 == x1 && y0 == y1)
+                break;
+            e2 = 2 * err;
+            if (e2 >= dy) {
+                err += dy;
+                x0 += sx;
+            }
+            if (e2 <= dx) {
+                err += dx;
+                y0 += sy;
+            }
         }
-    }
+    });
 }
 
 void wuLine(Display &points, int x0_int, int y0_int, int x1_int, int y1_int,
@@ -104,92 +111,226 @@ void wuLine(Display &points, int x0_int, int y0_int, int x1_int, int y1_int,
     int dx = x1 - x0;
     int dy = y1 - y0;
 
+    Bounds clip = points.bounds();
+
     if (dx == 0) {
-        if (x0_int >= 0 && x0_int < points.width && y0_int >= 0 &&
-            y0_int < points.height) {
-            points.pixels[y0_int * points.width + x0_int] = ctx.color;
+        if (x0_int >= clip.minX && x0_int <= clip.maxX &&
+            y0_int >= clip.minY && y0_int <= clip.maxY) {
+            points.pixels[(y0_int - clip.minY) * points.width +
+                          (x0_int - clip.minX)] = PixelFormat::store(ctx.color);
         }
         return;
     }
 
+    // The second sample of each step lands one pixel past y, so the extent
+    // grows by one on the minor axis.
+    Bounds extent{std::min(x0_int, x1_int), std::min(y0_int, y1_int),
+                  std::max(x0_int, x1_int), std::max(y0_int, y1_int)};
+    extent = extent.padded(1);
+    if (!extent.intersects(clip))
+        return;
+
     int32_t gradient_fp =
         static_cast<int32_t>((static_cast<int64_t>(dy) << 16) / dx);
     int32_t intery_fp = y0 << 16;
 
-    int width = points.width;
-    int height = points.height;
-
-    if (steep) {
-        for (int x = x0; x <= x1; x++) {
-            if (x < 0 || x >= height) {
-                intery_fp += gradient_fp;
-                continue;
-            }
+    // Walk only the major-axis range that is on screen.
+    int startX = std::max(steep ? clip.minY : clip.minX, x0);
+    int endX = std::min(steep ? clip.maxY : clip.maxX, x1);
+    if (startX > x0)
+        intery_fp += gradient_fp * (startX - x0);
 
+    auto walk = [&](const auto &writer, auto steepTag) {
+        for (int x = startX; x <= endX; x++) {
             int y_base = intery_fp >> 16;
-            uint8_t fraction = (intery_fp & 0xFFFF) >> 8;
-            uint8_t inv_fraction = 255 - fraction;
-
-            int rowIndex = x * width;
-
-            if (y_base >= 0 && y_base < width) {
-                Color src1 = sampleTexture(ctx, y_base, x);
-                Color *p1 = &points.pixels[rowIndex + y_base];
-                p1->r = (src1.r * inv_fraction + p1->r * fraction) >> 8;
-                p1->g = (src1.g * inv_fraction + p1->g * fraction) >> 8;
-                p1->b = (src1.b * inv_fraction + p1->b * fraction) >> 8;
-                p1->a = 255;
-            }
+            uint32_t fraction = (intery_fp & 0xFFFF) >> 8;
+            uint32_t inv_fraction = 255 - fraction;
 
-            if (y_base + 1 >= 0 && y_base + 1 < width) {
-                Color src2 = sampleTexture(ctx, y_base + 1, x);
-                Color *p2 = &points.pixels[rowIndex + y_base + 1];
-                p2->r = (src2.r * fraction + p2->r * inv_fraction) >> 8;
-                p2->g = (src2.g * fraction + p2->g * inv_fraction) >> 8;
-                p2->b = (src2.b * fraction + p2->b * inv_fraction) >> 8;
-                p2->a = 255;
+            if constexpr (decltype(steepTag)::value) {
+                writer.mix(y_base, x, inv_fraction);
+                writer.mix(y_base + 1, x, fraction);
+            } else {
+                writer.mix(x, y_base, inv_fraction);
+                writer.mix(x, y_base + 1, fraction);
             }
 
             intery_fp += gradient_fp;
         }
+    };
+
+    PixelPipeline::dispatch(points, ctx, extent, [&](const auto &writer) {
+        if (steep)
+            walk(writer, std::true_type{});
+        else
+            walk(writer, std::false_type{});
+    });
+}
+
+// Samples a textured span in fixed-size chunks and blends each chunk with
+// one span kernel call. sample() returns the next texel with the paint
+// alpha already applied.
+template <typename Sampler>
+static void texturedSpan(Pixel *dst, int count, Sampler &&sample) {
+    Color samples[64];
+    for (int done = 0; done < count; done += 64) {
+        int n = std::min(64, count - done);
+        for (int i = 0; i < n; i++)
+            samples[i] = sample();
+        blendSpan(dst + done, samples, n);
+    }
+}
+
+// Blends one horizontal span [startX, endX] on row y through the span
+// kernels, clipped to the target.
+static void paintSpan(Display &displayGrid, int y, int startX, int endX,
+                      const PaintCtx &ctx) {
+    Bounds clip = displayGrid.bounds();
+    if (y < clip.minY || y > clip.maxY)
+        return;
+    startX = std::max(clip.minX, startX);
+    endX = std::min(clip.maxX, endX);
+    if (startX > endX)
+        return;
+
+    Pixel *p = &displayGrid.pixels[(y - clip.minY) * displayGrid.width +
+                                   startX - clip.minX];
+    if (!ctx.texture) {
+        blendSolidSpan(p, endX - startX + 1, ctx.color, ctx.color.a);
     } else {
-        int startX = std::max(0, x0);
-        int endX = std::min(width - 1, x1);
+        PixelPipeline::withTexturedPaint(ctx, [&](const auto &paint) {
+            auto span = paint.span(startX, y);
+            texturedSpan(p, endX - startX + 1, [&] { return span.next(); });
+        });
+    }
+}
 
-        if (startX > x0)
-            intery_fp += gradient_fp * (startX - x0);
+// Spans for the rows cy - dy and cy + dy, once when dy is 0.
+static void paintSpanPair(Display &displayGrid, int cx, int cy, int dy,
+                          int half, const PaintCtx &ctx) {
+    paintSpan(displayGrid, cy + dy, cx - half, cx + half, ctx);
+    if (dy != 0)
+        paintSpan(displayGrid, cy - dy, cx - half, cx + half, ctx);
+}
 
-        for (int x = startX; x <= endX; x++) {
-            int y_base = intery_fp >> 16;
-            uint8_t fraction = (intery_fp & 0xFFFF) >> 8;
-            uint8_t inv_fraction = 255 - fraction;
-
-            if (y_base >= 0 && y_base < height) {
-                Color src1 = sampleTexture(ctx, x, y_base);
-                Color *p1 = &points.pixels[y_base * width + x];
-                p1->r = (src1.r * inv_fraction + p1->r * fraction) >> 8;
-                p1->g = (src1.g * inv_fraction + p1->g * fraction) >> 8;
-                p1->b = (src1.b * inv_fraction + p1->b * fraction) >> 8;
-                p1->a = 255;
-            }
+// Plots (±a, ±b) and (±b, ±a) around the centre, each pixel once.
+template <typename Writer>
+static void plotCircleOctants(const Writer &writer, int cx, int cy, int a,
+                              int b, uint32_t coverage) {
+    auto quadrants = [&](int u, int v) {
+        writer.plot(cx + u, cy + v, coverage);
+        if (v != 0)
+            writer.plot(cx + u, cy - v, coverage);
+        if (u != 0) {
+            writer.plot(cx - u, cy + v, coverage);
+            if (v != 0)
+                writer.plot(cx - u, cy - v, coverage);
+        }
+    };
+    quadrants(a, b);
+    if (a != b)
+        quadrants(b, a);
+}
 
-            if (y_base + 1 >= 0 && y_base + 1 < height) {
-                Color src2 = sampleTexture(ctx, x, y_base + 1);
-                Color *p2 = &points.pixels[(y_base + 1) * width + x];
-                p2->r = (src2.r * fraction + p2->r * inv_fraction) >> 8;
-                p2->g = (src2.g * fraction + p2->g * inv_fraction) >> 8;
-                p2->b = (src2.b * fraction + p2->b * inv_fraction) >> 8;
-                p2->a = 255;
-            }
+// floor(sqrt(value)) by Newton's method, starting from any guess that is not
+// below the root.
+static uint64_t sqrtFloor(uint64_t value, uint64_t guess) {
+    if (value == 0)
+        return 0;
+    if (guess == 0)
+        guess = value;
+    while (true) {
+        uint64_t next = (guess + value / guess) / 2;
+        if (next >= guess)
+            break;
+        guess = next;
+    }
+    while (guess * guess > value)
+        guess--;
+    return guess;
+}
 
-            intery_fp += gradient_fp;
+void midpointCircle(Display &displayGrid, int cx, int cy, int r,
+                    const PaintCtx &ctx) {
+    if (ctx.color.a == 0 || r < 0)
+        return;
+    Bounds extent{cx - r, cy - r, cx + r, cy + r};
+    if (!extent.intersects(displayGrid.bounds()))
+        return;
+
+    // Each midpoint step covers rows cy ± x with half-width y, and rows
+    // cy ± y with half-width x. x grows every step, so those rows are final
+    // at once; a y row is final just before y decrements. Every row is
+    // painted exactly once.
+    int x = 0;
+    int y = r;
+    int d = 3 - 2 * r;
+
+    while (y >= x) {
+        paintSpanPair(displayGrid, cx, cy, x, y, ctx);
+
+        if (d < 0) {
+            d = d + 4 * x + 6;
+        } else {
+            if (y != x)
+                paintSpanPair(displayGrid, cx, cy, y, x, ctx);
+            d = d + 4 * (x - y) + 10;
+            y--;
         }
+        x++;
     }
 }
 
+void aaCircle(Display &displayGrid, int cx, int cy, int r, bool fill,
+              const PaintCtx &ctx) {
+    if (ctx.color.a == 0 || r < 0)
+        return;
+    Bounds extent{cx - r - 1, cy - r - 1, cx + r + 1, cy + r + 1};
+    if (!extent.intersects(displayGrid.bounds()))
+        return;
+
+    int64_t r2 = static_cast<int64_t>(r) * r;
+
+    // The fill covers floor(sqrt(r^2 - dy^2)) on each row, which is exactly
+    // the set of inner outline pixels, so with a fill only the outer ring
+    // is anti-aliased.
+    if (fill) {
+        int64_t half = r;
+        for (int dy = 0; dy <= r; dy++) {
+            while (half * half > r2 - static_cast<int64_t>(dy) * dy)
+                half--;
+            paintSpanPair(displayGrid, cx, cy, dy, half, ctx);
+        }
+    }
+
+    // Wu-style outline over one octant: the exact edge sqrt(r^2 - x^2) in
+    // 8.8 fixed point splits coverage between the pixel below and above it.
+    PixelPipeline::dispatch(displayGrid, ctx, extent, [&](const auto &writer) {
+        uint64_t edge = static_cast<uint64_t>(r) << 8;
+        for (int x = 0;; x++) {
+            int64_t remaining = r2 - static_cast<int64_t>(x) * x;
+            if (remaining < 0)
+                break;
+            edge = sqrtFloor(static_cast<uint64_t>(remaining) << 16, edge);
+            int y = static_cast<int>(edge >> 8);
+            if (x > y)
+                break;
+
+            // Coverage c is written once as c(2 - c), the weight the edge
+            // had when every octant was blended twice.
+            uint32_t outer = edge & 0xFF;
+            uint32_t inner = 255 - outer;
+            if (!fill)
+                plotCircleOctants(writer, cx, cy, x, y,
+                                  inner * (510 - inner) / 255);
+            plotCircleOctants(writer, cx, cy, x, y + 1,
+                              outer * (510 - outer) / 255);
+        }
+    });
+}
+
 void scanlineFill(Display &displayGrid,
                   const std::vector<std::pair<int, int>> &vertices,
-                  const PaintCtx &ctx) {
+                  const PaintCtx &ctx, FillRule rule) {
     if (vertices.size() < 3)
         return;
 
@@ -199,55 +340,107 @@ void scanlineFill(Display &displayGrid,
         maxY = std::max(maxY, v.second);
     }
 
-    minY = std::max(0, minY);
-    maxY = std::min(displayGrid.height - 1, maxY);
+    Bounds clip = displayGrid.bounds();
+    minY = std::max(clip.minY, minY);
+    maxY = std::min(clip.maxY, maxY);
 
-    uint8_t finalAlpha = ctx.color.a;
-    if (finalAlpha == 0)
+    if (ctx.color.a == 0)
         return;
-    uint32_t invAlpha = 255 - finalAlpha;
-    uint32_t r = ctx.color.r;
-    uint32_t g = ctx.color.g;
-    uint32_t b = ctx.color.b;
-    bool hasTexture = (ctx.texture != nullptr);
 
-    std::vector<int> nodes;
-    nodes.reserve(16);
+    // Edge table, built once and sorted by top scanline. An edge covers the
+    // rows yMin < y <= yMax, like the quad overload below.
+    struct Edge {
+        int yMin, yMax;
+        int32_t x_fp;
+        int32_t dx_fp;
+        int winding;
+    };
+
     size_t n = vertices.size();
+    std::vector<Edge> edges;
+    edges.reserve(n);
 
-    for (int y = minY; y <= maxY; y++) {
-        nodes.clear();
+    for (size_t i = 0; i < n; i++) {
+        const auto &p1 = vertices[i];
+        const auto &p2 = vertices[(i + 1) % n];
+        if (p1.second == p2.second)
+            continue;
 
-        for (size_t i = 0; i < n; i++) {
-            size_t j = (i + 1) % n;
-            int xi = vertices[i].first, yi = vertices[i].second;
-            int xj = vertices[j].first, yj = vertices[j].second;
+        bool down = p1.second < p2.second;
+        const auto &top = down ? p1 : p2;
+        const auto &bottom = down ? p2 : p1;
+
+        Edge e;
+        e.yMin = top.second;
+        e.yMax = bottom.second;
+        e.x_fp = top.first << 16;
+        e.dx_fp = static_cast<int32_t>(
+            (static_cast<int64_t>(bottom.first - top.first) << 16) /
+            (bottom.second - top.second));
+        e.winding = down ? 1 : -1;
+        edges.push_back(e);
+    }
 
-            if ((yi < y && yj >= y) || (yj < y && yi >= y))
-                nodes.push_back(xi + (y - yi) * (xj - xi) / (yj - yi));
-        }
+    std::sort(edges.begin(), edges.end(),
+              [](const Edge &a, const Edge &b) { return a.yMin < b.yMin; });
 
-        std::sort(nodes.begin(), nodes.end());
+    struct ActiveEdge {
+        int yMax;
+        int32_t x_fp;
+        int32_t dx_fp;
+        int winding;
+    };
 
-        for (size_t k = 0; k + 1 < nodes.size(); k += 2) {
-            int startX = std::max(0, nodes[k]);
-            int endX = std::min(displayGrid.width - 1, nodes[k + 1]);
+    std::vector<ActiveEdge> active;
+    active.reserve(edges.size());
+    size_t nextEdge = 0;
+
+    for (int y = minY; y <= maxY; y++) {
+        // Retire finished edges and step the rest by one scanline.
+        size_t kept = 0;
+        for (size_t i = 0; i < active.size(); i++) {
+            if (active[i].yMax < y)
+                continue;
+            active[i].x_fp += active[i].dx_fp;
+            active[kept++] = active[i];
+        }
+        active.resize(kept);
 
-            if (startX > endX)
+        while (nextEdge < edges.size() && edges[nextEdge].yMin < y) {
+            const Edge &e = edges[nextEdge++];
+            if (e.yMax < y)
                 continue;
+            int32_t x_fp = static_cast<int32_t>(
+                e.x_fp + static_cast<int64_t>(y - e.yMin) * e.dx_fp);
+            active.push_back({e.yMax, x_fp, e.dx_fp, e.winding});
+        }
 
-            if (!hasTexture) {
-                Color *p = &displayGrid.pixels[y * displayGrid.width + startX];
-                for (int x = startX; x <= endX; x++) {
-                    p->r = (r * finalAlpha + p->r * invAlpha) >> 8;
-                    p->g = (g * finalAlpha + p->g * invAlpha) >> 8;
-                    p->b = (b * finalAlpha + p->b * invAlpha) >> 8;
-                    p->a = 255;
-                    p++;
-                }
-            } else {
-                for (int x = startX; x <= endX; x++)
-                    addPixel(displayGrid, x, y, 1.0f, ctx);
+        // The list stays nearly sorted between rows, so insertion sort is
+        // close to linear.
+        for (size_t i = 1; i < active.size(); i++) {
+            ActiveEdge current = active[i];
+            size_t j = i;
+            while (j > 0 && active[j - 1].x_fp > current.x_fp) {
+                active[j] = active[j - 1];
+                j--;
+            }
+            active[j] = current;
+        }
+
+        if (rule == FillRule::EvenOdd) {
+            for (size_t k = 0; k + 1 < active.size(); k += 2)
+                paintSpan(displayGrid, y, active[k].x_fp >> 16,
+                          active[k + 1].x_fp >> 16, ctx);
+        } else {
+            int winding = 0;
+            int spanStart = 0;
+            for (const auto &e : active) {
+                int before = winding;
+                winding += e.winding;
+                if (before == 0 && winding != 0)
+                    spanStart = e.x_fp >> 16;
+                else if (before != 0 && winding == 0)
+                    paintSpan(displayGrid, y, spanStart, e.x_fp >> 16, ctx);
             }
         }
     }
@@ -261,16 +454,13 @@ void scanlineFill(Display &displayGrid,
     int maxY = std::max({vertices[0].second, vertices[1].second,
                          vertices[2].second, vertices[3].second});
 
-    minY = std::max(0, minY);
-    maxY = std::min(displayGrid.height - 1, maxY);
+    Bounds clip = displayGrid.bounds();
+    minY = std::max(clip.minY, minY);
+    maxY = std::min(clip.maxY, maxY);
 
     uint8_t finalAlpha = ctx.color.a;
     if (finalAlpha == 0)
         return;
-    uint32_t invAlpha = 255 - finalAlpha;
-    uint32_t r = ctx.color.r;
-    uint32_t g = ctx.color.g;
-    uint32_t b = ctx.color.b;
     bool hasTexture = (ctx.texture != nullptr);
 
     struct Edge {
@@ -330,51 +520,25 @@ void scanlineFill(Display &displayGrid,
         if (xStart > xEnd)
             std::swap(xStart, xEnd);
 
-        xStart = std::max(0, xStart);
-        xEnd = std::min(displayGrid.width - 1, xEnd);
+        xStart = std::max(clip.minX, xStart);
+        xEnd = std::min(clip.maxX, xEnd);
 
         if (xStart > xEnd)
             continue;
 
-        Color *targetPixel =
-            &displayGrid.pixels[y * displayGrid.width + xStart];
+        Pixel *targetPixel =
+            &displayGrid.pixels[(y - clip.minY) * displayGrid.width + xStart -
+                                clip.minX];
 
         if (!hasTexture) {
-            for (int x = xStart; x <= xEnd; ++x) {
-                targetPixel->r =
-                    (r * finalAlpha + targetPixel->r * invAlpha) >> 8;
-                targetPixel->g =
-                    (g * finalAlpha + targetPixel->g * invAlpha) >> 8;
-                targetPixel->b =
-                    (b * finalAlpha + targetPixel->b * invAlpha) >> 8;
-                targetPixel->a = 255;
-                targetPixel++;
-            }
+            blendSolidSpan(targetPixel, xEnd - xStart + 1, ctx.color,
+                           finalAlpha);
         } else {
-            float cur_u = ctx.tex_A * xStart + ctx.tex_B * y + ctx.tex_C;
-            float cur_v = ctx.tex_D * xStart + ctx.tex_E * y + ctx.tex_F;
-
-            for (int x = xStart; x <= xEnd; ++x) {
-                int u = static_cast<int>(cur_u + 0.5f);
-                int v = static_cast<int>(cur_v + 0.5f);
-
-                Color texColor = ctx.texture->sample(u, v);
-                uint32_t sampledAlpha = (texColor.a * ctx.color.a) >> 8;
-                uint32_t texAlpha = (finalAlpha * sampledAlpha) >> 8;
-                uint32_t invTexAlpha = 255 - texAlpha;
-
-                targetPixel->r =
-                    (texColor.r * texAlpha + targetPixel->r * invTexAlpha) >> 8;
-                targetPixel->g =
-                    (texColor.g * texAlpha + targetPixel->g * invTexAlpha) >> 8;
-                targetPixel->b =
-                    (texColor.b * texAlpha + targetPixel->b * invTexAlpha) >> 8;
-                targetPixel->a = 255;
-                targetPixel++;
-
-                cur_u += ctx.tex_A;
-                cur_v += ctx.tex_D;
-            }
+            PixelPipeline::withTexturedPaint(ctx, [&](const auto &paint) {
+                auto span = paint.span(xStart, y);
+                texturedSpan(targetPixel, xEnd - xStart + 1,
+                             [&] { return span.next(); });
+            });
         }
     }
 }
@@ -0,0 +1,148 @@
+#include "FramePresenter.hpp"
+#include <algorithm>
+
+static const char *TAG = "FramePresenter";
+
+void MemorySink::present(const Display &frame, uint64_t frameIndex) {
+    std::lock_guard<std::mutex> lock(mutex);
+    last.width = frame.width;
+    last.height = frame.height;
+    last.originX = frame.originX;
+    last.originY = frame.originY;
+    last.pixels.assign(frame.pixels.begin(), frame.pixels.end());
+    lastIndex = frameIndex;
+    frames.fetch_add(1);
+}
+
+bool MemorySink::lastFrame(Display &out, uint64_t *frameIndex) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (frames.load() == 0)
+        return false;
+    out.width = last.width;
+    out.height = last.height;
+    out.originX = last.originX;
+    out.originY = last.originY;
+    out.pixels.assign(last.pixels.begin(), last.pixels.end());
+    if (frameIndex)
+        *frameIndex = lastIndex;
+    return true;
+}
+
+FileSink::FileSink(const std::string &path) {
+    file = fopen(path.c_str(), "wb");
+    if (!file)
+        RENDERER_LOGE(TAG, "Failed to open output file: %s", path.c_str());
+}
+
+FileSink::~FileSink() {
+    if (file)
+        fclose(file);
+}
+
+void FileSink::present(const Display &frame, uint64_t frameIndex) {
+    if (!file)
+        return;
+
+    fprintf(file, "P6\n# frame %llu\n%d %d\n255\n",
+            static_cast<unsigned long long>(frameIndex), frame.width,
+            frame.height);
+    row.resize(frame.width * 3);
+    for (int y = 0; y < frame.height; y++) {
+        const Pixel *src = &frame.pixels[y * frame.width];
+        for (int x = 0; x < frame.width; x++) {
+            Color c = PixelFormat::load(src[x]);
+            row[x * 3 + 0] = c.r;
+            row[x * 3 + 1] = c.g;
+            row[x * 3 + 2] = c.b;
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+}
+
+FramePresenter::FramePresenter(int width, int height,
+                               std::unique_ptr<PresentSink> sink,
+                               int bufferCount)
+    : frameWidth(width), frameHeight(height), sink(std::move(sink)) {
+    bufferCount = std::clamp(bufferCount, 2, MaxBuffers);
+    buffers.resize(bufferCount);
+    for (int i = 0; i < bufferCount; i++) {
+        buffers[i].width = width;
+        buffers[i].height = height;
+        buffers[i].pixels.resize(width * height, PixelFormat::store(Color()));
+        freeBuffers.push(i);
+    }
+
+    output = std::thread(&FramePresenter::outputLoop, this);
+}
+
+FramePresenter::~FramePresenter() {
+    flush();
+    running.store(false);
+    pendingSignal.fetch_add(1, std::memory_order_release);
+    pendingSignal.notify_one();
+    output.join();
+}
+
+Display &FramePresenter::acquire() {
+    if (acquired >= 0) {
+        RENDERER_LOGW(TAG, "acquire() without submit(); reusing buffer");
+        return buffers[acquired];
+    }
+
+    int index;
+    uint32_t seen = freeSignal.load(std::memory_order_acquire);
+    while (!freeBuffers.pop(index)) {
+        freeSignal.wait(seen, std::memory_order_acquire);
+        seen = freeSignal.load(std::memory_order_acquire);
+    }
+    acquired = index;
+    return buffers[index];
+}
+
+void FramePresenter::submit() {
+    if (acquired < 0) {
+        RENDERER_LOGE(TAG, "submit() without a matching acquire()");
+        return;
+    }
+
+    // Cannot fail: a queue holds all buffers and this one was not queued.
+    pendingFrames.push(acquired);
+    acquired = -1;
+    submitted++;
+    pendingSignal.fetch_add(1, std::memory_order_release);
+    pendingSignal.notify_one();
+}
+
+void FramePresenter::flush() {
+    uint64_t target = submitted;
+    uint64_t done = presented.load(std::memory_order_acquire);
+    while (done < target) {
+        presented.wait(done, std::memory_order_acquire);
+        done = presented.load(std::memory_order_acquire);
+    }
+}
+
+void FramePresenter::outputLoop() {
+    uint64_t frameIndex = 0;
+    while (true) {
+        int index;
+        uint32_t seen = pendingSignal.load(std::memory_order_acquire);
+        if (!pendingFrames.pop(index)) {
+            if (!running.load())
+                break;
+            pendingSignal.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+
+        if (sink)
+            sink->present(buffers[index], frameIndex);
+        frameIndex++;
+
+        freeBuffers.push(index);
+        freeSignal.fetch_add(1, std::memory_order_release);
+        freeSignal.notify_one();
+
+        presented.fetch_add(1, std::memory_order_release);
+        presented.notify_all();
+    }
+}
@@ -0,0 +1,103 @@
+#include "Collider.hpp"
+#include "Shapes/Shape.hpp"
+#include "Texture.hpp"
+#include <climits>
+
+MaskCollider::MaskCollider(int x, int y, int width, int height)
+    : Collider(ColliderType::MASK, x, y), width(std::max(width, 0)),
+      height(std::max(height, 0)), wordsPerRow((this->width + 63) / 64),
+      bits(static_cast<size_t>(wordsPerRow) * this->height, 0) {}
+
+MaskCollider MaskCollider::fromTexture(const Texture &texture, int x, int y,
+                                       uint8_t alphaThreshold) {
+    if (!texture.isValid())
+        return MaskCollider(x, y, 0, 0);
+    MaskCollider mask(x, y, texture.getWidth(), texture.getHeight());
+    texture.withSampler([&](const auto &sampler) {
+        for (int row = 0; row < mask.height; row++) {
+            for (int column = 0; column < mask.width; column++) {
+                if (sampler.at(column, row).a >= alphaThreshold)
+                    mask.set(column, row);
+            }
+        }
+    });
+    return mask;
+}
+
+MaskCollider MaskCollider::fromShape(Shape &shape) {
+    shape.prepareDraw();
+    Bounds area = shape.bounds();
+    if (area.empty() || area.minX == INT_MIN || area.maxX == INT_MAX ||
+        area.minY == INT_MIN || area.maxY == INT_MAX)
+        return MaskCollider(area.minX, area.minY, 0, 0);
+
+    // Drawn into a cleared offscreen layer; every written pixel is solid.
+    Display layer;
+    layer.width = area.maxX - area.minX + 1;
+    layer.height = area.maxY - area.minY + 1;
+    layer.originX = area.minX;
+    layer.originY = area.minY;
+    layer.pixels.assign(layer.width * layer.height,
+                        PixelFormat::transparent());
+    shape.drawAliased(layer);
+
+    MaskCollider mask(area.minX, area.minY, layer.width, layer.height);
+    for (int row = 0; row < layer.height; row++) {
+        for (int column = 0; column < layer.width; column++) {
+            if (!PixelFormat::isTransparent(
+                    layer.pixels[row * layer.width + column]))
+                mask.set(column, row);
+        }
+    }
+    return mask;
+}
+
+void MaskCollider::set(int column, int row, bool solid) {
+    if (column < 0 || column >= width || row < 0 || row >= height)
+        return;
+    uint64_t &word = bits[row * wordsPerRow + (column >> 6)];
+    uint64_t bit = 1ull << (column & 63);
+    word = solid ? word | bit : word & ~bit;
+}
+
+bool MaskCollider::solid(int column, int row) const {
+    if (column < 0 || column >= width || row < 0 || row >= height)
+        return false;
+    return bits[row * wordsPerRow + (column >> 6)] >> (column & 63) & 1;
+}
+
+bool MaskCollider::anySolid(int row, int first, int last) const {
+    first = std::max(first, 0);
+    last = std::min(last, width - 1);
+    if (row < 0 || row >= height || first > last)
+        return false;
+    const uint64_t *words = bits.data() + row * wordsPerRow;
+    int firstWord = first >> 6;
+    int lastWord = last >> 6;
+    for (int w = firstWord; w <= lastWord; w++) {
+        uint64_t covered = ~0ull;
+        if (w == firstWord)
+            covered &= ~0ull << (first & 63);
+        if (w == lastWord)
+            covered &= ~0ull >> (63 - (last & 63));
+        if (words[w] & covered)
+            return true;
+    }
+    return false;
+}
+
+uint64_t MaskCollider::bitsAt(int row, int column) const {
+    if (row < 0 || row >= height)
+        return 0;
+    const uint64_t *words = bits.data() + row * wordsPerRow;
+    // Arithmetic shift: columns left of the mask give negative words.
+    int w = column >> 6;
+    int offset = column & 63;
+    auto word = [&](int i) {
+        return i >= 0 && i < wordsPerRow ? words[i] : 0ull;
+    };
+    uint64_t result = word(w) >> offset;
+    if (offset)
+        result |= word(w + 1) << (64 - offset);
+    return result;
+}
@@ -0,0 +1,61 @@
+#include "PixelFormat.hpp"
+#include <algorithm>
+#include <climits>
+
+namespace Palette {
+Color entries[Size];
+uint8_t lookup[4096];
+
+static int usedEntries = 0;
+
+// Fills the 4-4-4 table with the nearest used entry to each cell's
+// representative colour (nibble replicated, so black and white are exact).
+static void rebuildLookup() {
+    for (int cell = 0; cell < 4096; cell++) {
+        int r = (cell >> 8) * 0x11;
+        int g = ((cell >> 4) & 0xF) * 0x11;
+        int b = (cell & 0xF) * 0x11;
+
+        int best = 0;
+        int bestDistance = INT_MAX;
+        for (int i = 0; i < usedEntries; i++) {
+            int dr = r - entries[i].r;
+            int dg = g - entries[i].g;
+            int db = b - entries[i].b;
+            int distance = 2 * dr * dr + 4 * dg * dg + 3 * db * db;
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best = i;
+            }
+        }
+        lookup[cell] = best;
+    }
+}
+
+void set(const Color *colors, int count) {
+    usedEntries = std::clamp(count, 1, Size - 1);
+    for (int i = 0; i < std::min(count, Size - 1); i++)
+        entries[i] = Color(colors[i].r, colors[i].g, colors[i].b);
+    rebuildLookup();
+}
+
+#if RENDERER_PIXEL_FORMAT == RENDERER_PIXEL_INDEXED8
+// Default palette: a 6x6x6 colour cube followed by a 39-step gray ramp,
+// with black as the transparent key in the reserved last entry.
+static const bool defaultPalette = [] {
+    Color colors[Size - 1];
+    int n = 0;
+    for (int r = 0; r < 6; r++)
+        for (int g = 0; g < 6; g++)
+            for (int b = 0; b < 6; b++)
+                colors[n++] = Color(r * 51, g * 51, b * 51);
+    while (n < Size - 1) {
+        uint8_t level = (n - 215) * 255 / 40;
+        colors[n++] = Color(level, level, level);
+    }
+    entries[TransparentIndex] = Color(0, 0, 0);
+    set(colors, n);
+    return true;
+}();
+#endif
+} // namespace Palette
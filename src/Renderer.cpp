@@ -4,27 +4,317 @@
 #include <memory>
 #include <vector>
 
+static const char *TAG = "Renderer";
+
 Renderer::Renderer(int width, int height) : width(width), height(height) {
     displayGrid.width = width;
     displayGrid.height = height;
-    displayGrid.pixels.resize(width * height, Color());
+    displayGrid.pixels.resize(width * height, PixelFormat::store(Color()));
+}
+
+void Renderer::setTiling(int tileSize, unsigned workers) {
+    this->tileSize = tileSize;
+    if (tileSize <= 0) {
+        workerPool.reset();
+        return;
+    }
+
+    if (!workerPool || (workers != 0 && workerPool->size() != workers))
+        workerPool = std::make_unique<WorkerPool>(workers);
+}
+
+void Renderer::setDirtyTracking(bool enabled) {
+    dirtyTracking = enabled;
+    fullRedraw = true;
+    trackedShapes.clear();
+    textDamage.clear();
 }
 
 void Renderer::clear() {
-    std::fill(displayGrid.pixels.begin(), displayGrid.pixels.end(), Color());
+    std::fill(displayGrid.pixels.begin(), displayGrid.pixels.end(),
+              PixelFormat::store(Color()));
+    fullRedraw = true;
 }
 
 void Renderer::render(
     const std::vector<std::shared_ptr<Collection>> &collections,
     const DrawOptions &options) {
-    std::vector<std::shared_ptr<Collection>> sortedCollections = collections;
-    std::sort(sortedCollections.begin(), sortedCollections.end(),
-              [](std::shared_ptr<Collection> a, std::shared_ptr<Collection> b) {
-                  return a->z() < b->z();
-              });
+    // Raw pointers: the caller's vector keeps the collections alive, and
+    // copying shared_ptrs would cost two atomic operations per element.
+    sortedCollections.clear();
+    for (const auto &collection : collections)
+        sortedCollections.push_back(collection.get());
+    std::stable_sort(sortedCollections.begin(), sortedCollections.end(),
+                     [](const Collection *a, const Collection *b) {
+                         return a->z() < b->z();
+                     });
+
+    if (tileSize <= 0 && !dirtyTracking) {
+        for (Collection *collection : sortedCollections)
+            collection->draw(displayGrid, options);
+        return;
+    }
+
+    drawables.clear();
+    for (Collection *collection : sortedCollections) {
+        collection->prepareDraw();
+        collection->collectDrawables(drawables, options);
+    }
+    prepareDrawables();
+
+    if (dirtyTracking) {
+        collectDamage();
+        mergeDamage();
+        binDamage();
+        rasterizeRegions(options, true);
+    } else {
+        binTiles();
+        rasterizeRegions(options, false);
+    }
+}
+
+void Renderer::render(SceneStore &scene, const DrawOptions &options) {
+    scene.draw(displayGrid, options);
+    fullRedraw = true;
+}
+
+void Renderer::present(FramePresenter &presenter) {
+    if (presenter.width() != width || presenter.height() != height) {
+        RENDERER_LOGE(TAG, "Presenter is %dx%d, renderer is %dx%d",
+                      presenter.width(), presenter.height(), width, height);
+        return;
+    }
+
+    Display &frame = presenter.acquire();
+    std::swap(frame.pixels, displayGrid.pixels);
+    if (dirtyTracking)
+        std::copy(frame.pixels.begin(), frame.pixels.end(),
+                  displayGrid.pixels.begin());
+    presenter.submit();
+}
+
+void Renderer::prepareDrawables() {
+    // All shape state is updated here on the calling thread; region workers
+    // only read it.
+    Bounds screen = displayGrid.bounds();
+    drawableBounds.resize(drawables.size());
+    for (size_t i = 0; i < drawables.size(); i++) {
+        drawables[i]->prepareDraw();
+        drawableBounds[i] = drawables[i]->bounds().intersection(screen);
+    }
+}
+
+void Renderer::binTiles() {
+    int tilesX = (width + tileSize - 1) / tileSize;
+    int tilesY = (height + tileSize - 1) / tileSize;
+
+    regions.clear();
+    regionItems.resize(tilesX * tilesY);
+    for (int ty = 0; ty < tilesY; ty++) {
+        for (int tx = 0; tx < tilesX; tx++) {
+            int x = tx * tileSize;
+            int y = ty * tileSize;
+            regions.push_back({x, y, std::min(x + tileSize, width) - 1,
+                               std::min(y + tileSize, height) - 1});
+            regionItems[regions.size() - 1].clear();
+        }
+    }
+
+    for (size_t i = 0; i < drawables.size(); i++) {
+        const Bounds &visible = drawableBounds[i];
+        if (visible.empty())
+            continue;
+
+        for (int ty = visible.minY / tileSize; ty <= visible.maxY / tileSize;
+             ty++) {
+            for (int tx = visible.minX / tileSize;
+                 tx <= visible.maxX / tileSize; tx++)
+                regionItems[ty * tilesX + tx].push_back(i);
+        }
+    }
+}
+
+void Renderer::collectDamage() {
+    damage.clear();
+    frameCounter++;
+
+    for (size_t i = 0; i < drawables.size(); i++) {
+        const Shape *shape = drawables[i];
+        const Bounds &current = drawableBounds[i];
+        bool changed = drawables[i]->consumeRedraw();
+
+        auto it = trackedShapes.find(shape);
+        if (it == trackedShapes.end()) {
+            damage.push_back(current);
+            trackedShapes.emplace(shape, TrackedShape{current, frameCounter});
+            continue;
+        }
+
+        if (changed || it->second.bounds != current) {
+            damage.push_back(it->second.bounds);
+            damage.push_back(current);
+            it->second.bounds = current;
+        }
+        it->second.frame = frameCounter;
+    }
+
+    // Shapes that were not drawn this frame leave a hole behind.
+    for (auto it = trackedShapes.begin(); it != trackedShapes.end();) {
+        if (it->second.frame != frameCounter) {
+            damage.push_back(it->second.bounds);
+            it = trackedShapes.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
-    for (std::shared_ptr<Collection> collection : sortedCollections) {
-        collection->draw(displayGrid, options);
+    damage.insert(damage.end(), textDamage.begin(), textDamage.end());
+    textDamage.clear();
+
+    if (fullRedraw) {
+        damage.assign(1, displayGrid.bounds());
+        fullRedraw = false;
+    }
+
+    damage.erase(std::remove_if(damage.begin(), damage.end(),
+                                [](const Bounds &b) { return b.empty(); }),
+                 damage.end());
+}
+
+static int64_t area(const Bounds &b) {
+    return static_cast<int64_t>(b.maxX - b.minX + 1) * (b.maxY - b.minY + 1);
+}
+
+void Renderer::mergeDamage() {
+    const size_t maxRegions = 16;
+
+    if (damage.size() > maxRegions * 4) {
+        Bounds all;
+        for (const auto &b : damage)
+            all.expand(b);
+        damage.assign(1, all);
+        return;
+    }
+
+    // Overlapping rectangles are always merged so regions can be rasterized
+    // independently. Disjoint ones are merged when that does not add area,
+    // or when there are too many of them.
+    while (damage.size() > 1) {
+        size_t bestI = 0, bestJ = 0;
+        int64_t bestGrowth = INT64_MAX;
+        bool mustMerge = false;
+
+        for (size_t i = 0; i < damage.size() && !mustMerge; i++) {
+            for (size_t j = i + 1; j < damage.size(); j++) {
+                Bounds merged = damage[i];
+                merged.expand(damage[j]);
+                int64_t growth =
+                    area(merged) - area(damage[i]) - area(damage[j]);
+                if (damage[i].intersects(damage[j]) || growth <= 0) {
+                    bestI = i;
+                    bestJ = j;
+                    mustMerge = true;
+                    break;
+                }
+                if (growth < bestGrowth) {
+                    bestGrowth = growth;
+                    bestI = i;
+                    bestJ = j;
+                }
+            }
+        }
+
+        if (!mustMerge && damage.size() <= maxRegions)
+            break;
+
+        damage[bestI].expand(damage[bestJ]);
+        damage.erase(damage.begin() + bestJ);
+    }
+}
+
+void Renderer::binDamage() {
+    regions.clear();
+    for (const auto &rect : damage) {
+        if (tileSize <= 0) {
+            regions.push_back(rect);
+            continue;
+        }
+
+        // Split large damage regions along the tile grid so they spread
+        // over the worker pool.
+        for (int y = rect.minY - rect.minY % tileSize; y <= rect.maxY;
+             y += tileSize) {
+            for (int x = rect.minX - rect.minX % tileSize; x <= rect.maxX;
+                 x += tileSize) {
+                regions.push_back(Bounds(x, y, x + tileSize - 1,
+                                         y + tileSize - 1)
+                                      .intersection(rect));
+            }
+        }
+    }
+
+    regionItems.resize(regions.size());
+    for (size_t r = 0; r < regions.size(); r++) {
+        regionItems[r].clear();
+        for (size_t i = 0; i < drawables.size(); i++) {
+            if (drawableBounds[i].intersects(regions[r]))
+                regionItems[r].push_back(i);
+        }
+    }
+}
+
+void Renderer::rasterizeRegions(const DrawOptions &options, bool clearFirst) {
+    auto job = [&](int region, unsigned worker) {
+        if (!clearFirst && regionItems[region].empty())
+            return;
+        rasterizeRegion(regionBuffers[worker], regions[region],
+                        regionItems[region], options, clearFirst);
+    };
+
+    if (workerPool) {
+        regionBuffers.resize(workerPool->size());
+        workerPool->run(regions.size(), job);
+    } else {
+        regionBuffers.resize(1);
+        for (size_t r = 0; r < regions.size(); r++)
+            job(r, 0);
+    }
+}
+
+void Renderer::rasterizeRegion(Display &buffer, const Bounds &region,
+                               const std::vector<uint32_t> &items,
+                               const DrawOptions &options, bool clearFirst) {
+    int regionWidth = region.maxX - region.minX + 1;
+    int regionHeight = region.maxY - region.minY + 1;
+
+    buffer.width = regionWidth;
+    buffer.height = regionHeight;
+    buffer.originX = region.minX;
+    buffer.originY = region.minY;
+    buffer.pixels.resize(regionWidth * regionHeight);
+
+    if (clearFirst) {
+        std::fill(buffer.pixels.begin(), buffer.pixels.end(),
+                  PixelFormat::store(Color()));
+    } else {
+        for (int y = 0; y < regionHeight; y++) {
+            const Pixel *src =
+                &displayGrid.pixels[(region.minY + y) * width + region.minX];
+            std::copy(src, src + regionWidth, &buffer.pixels[y * regionWidth]);
+        }
+    }
+
+    for (uint32_t item : items) {
+        if (options.antialias)
+            drawables[item]->drawAntiAliased(buffer);
+        else
+            drawables[item]->drawAliased(buffer);
+    }
+
+    for (int y = 0; y < regionHeight; y++) {
+        const Pixel *src = &buffer.pixels[y * regionWidth];
+        std::copy(src, src + regionWidth,
+                  &displayGrid.pixels[(region.minY + y) * width + region.minX]);
     }
 }
 
@@ -34,9 +324,11 @@ void Renderer::drawText(const std::string &text, int x, int y, const Font &font,
     int currentY = y;
     int lineHeight = font.getHeight() + 1;
 
+    Bounds drawn;
     auto setPixel = [&](int px, int py, const Color &c) {
         if (px >= 0 && px < width && py >= 0 && py < height) {
-            displayGrid.pixels[py * width + px] = c;
+            displayGrid.pixels[py * width + px] = PixelFormat::store(c);
+            drawn.expand(px, py);
         }
     };
 
@@ -88,4 +380,9 @@ void Renderer::drawText(const std::string &text, int x, int y, const Font &font,
 
         currentX += glyph->width + font.getCharSpacing(c);
     }
+
+    // The shapes under the text are repainted on the next tracked render,
+    // which erases it before it is drawn again.
+    if (dirtyTracking && !drawn.empty())
+        textDamage.push_back(drawn);
 }
@@ -0,0 +1,353 @@
+#include "SceneStore.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+static const char *TAG = "SceneStore";
+
+SceneHandle SceneStore::createGroup(const ShapeParams &params,
+                                    SceneHandle parent) {
+    return createNode(params, Kind::Group, 0, parent);
+}
+
+SceneHandle SceneStore::createCircle(const CircleParams &params,
+                                     SceneHandle parent) {
+    SceneHandle handle =
+        createNode(params, Kind::Circle, circles.size(), parent);
+    if (!handle.isNull())
+        circles.push_back({handle.index, params.radius, params.fill});
+    return handle;
+}
+
+SceneHandle SceneStore::createRectangle(const RectangleParams &params,
+                                        SceneHandle parent) {
+    SceneHandle handle =
+        createNode(params, Kind::Rectangle, rectangles.size(), parent);
+    if (!handle.isNull())
+        rectangles.push_back(
+            {handle.index, params.width, params.height, params.fill});
+    return handle;
+}
+
+SceneHandle SceneStore::createLine(const LineSegmentParams &params,
+                                   SceneHandle parent) {
+    SceneHandle handle = createNode(params, Kind::Line, lines.size(), parent);
+    if (!handle.isNull())
+        lines.push_back({handle.index, static_cast<int>(params.x2 - params.x),
+                         static_cast<int>(params.y2 - params.y)});
+    return handle;
+}
+
+SceneHandle SceneStore::createNode(const ShapeParams &params, Kind kind,
+                                   uint32_t data, SceneHandle parent) {
+    uint32_t parentIndex = SceneHandle::None;
+    uint16_t depth = 0;
+    if (!parent.isNull()) {
+        const Node *parentNode = resolve(parent);
+        if (!parentNode) {
+            RENDERER_LOGE(TAG, "Parent handle %u is no longer valid",
+                          parent.index);
+            return {};
+        }
+        parentIndex = parent.index;
+        depth = parentNode->depth + 1;
+    }
+
+    uint32_t index;
+    if (!freeNodes.empty()) {
+        index = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        index = nodes.size();
+        nodes.push_back({});
+        nodes[index].generation = 0;
+        world.emplace_back();
+        nodeBounds.emplace_back();
+    }
+
+    Node &node = nodes[index];
+    node.x = params.x;
+    node.y = params.y;
+    node.cosAngle = 1.0f;
+    node.sinAngle = 0.0f;
+    node.angle = 0.0f;
+    node.pivotX = 0;
+    node.pivotY = 0;
+    node.z = static_cast<int>(params.z);
+    node.color = params.color;
+    node.parent = parentIndex;
+    node.data = data;
+    node.sequence = nextSequence++;
+    node.depth = depth;
+    node.kind = kind;
+    node.alive = true;
+    nodeBounds[index] = Bounds();
+
+    orderDirty = true;
+    return {index, node.generation};
+}
+
+SceneStore::Node *SceneStore::resolve(SceneHandle handle) {
+    return const_cast<Node *>(std::as_const(*this).resolve(handle));
+}
+
+const SceneStore::Node *SceneStore::resolve(SceneHandle handle) const {
+    if (handle.index >= nodes.size())
+        return nullptr;
+    const Node &node = nodes[handle.index];
+    if (!node.alive || node.generation != handle.generation)
+        return nullptr;
+    return &node;
+}
+
+bool SceneStore::valid(SceneHandle handle) const {
+    return resolve(handle) != nullptr;
+}
+
+template <typename T>
+void SceneStore::removeData(std::vector<T> &items, uint32_t index) {
+    if (index + 1 != items.size()) {
+        items[index] = items.back();
+        nodes[items[index].node].data = index;
+    }
+    items.pop_back();
+}
+
+void SceneStore::releaseNode(uint32_t index) {
+    Node &node = nodes[index];
+    switch (node.kind) {
+    case Kind::Circle:
+        removeData(circles, node.data);
+        break;
+    case Kind::Rectangle:
+        removeData(rectangles, node.data);
+        break;
+    case Kind::Line:
+        removeData(lines, node.data);
+        break;
+    case Kind::Group:
+        break;
+    }
+    node.alive = false;
+    node.generation++;
+    freeNodes.push_back(index);
+    orderDirty = true;
+}
+
+void SceneStore::destroy(SceneHandle handle) {
+    if (!resolve(handle))
+        return;
+    if (orderDirty)
+        rebuildOrder();
+
+    // Parents come first in transformOrder, so one pass reaches every
+    // descendant after its parent has been released.
+    releaseNode(handle.index);
+    for (uint32_t index : transformOrder) {
+        const Node &node = nodes[index];
+        if (node.alive && node.parent != SceneHandle::None &&
+            !nodes[node.parent].alive)
+            releaseNode(index);
+    }
+}
+
+void SceneStore::clear() {
+    for (uint32_t index = 0; index < nodes.size(); index++) {
+        if (nodes[index].alive)
+            releaseNode(index);
+    }
+}
+
+void SceneStore::setPosition(SceneHandle handle, float x, float y) {
+    if (Node *node = resolve(handle)) {
+        node->x = x;
+        node->y = y;
+    }
+}
+
+void SceneStore::translate(SceneHandle handle, float dx, float dy) {
+    if (Node *node = resolve(handle)) {
+        node->x += dx;
+        node->y += dy;
+    }
+}
+
+void SceneStore::setRotation(SceneHandle handle, float angle) {
+    if (Node *node = resolve(handle)) {
+        float angleRad = angle * M_PI / 180.0f;
+        node->angle = angle;
+        node->cosAngle = std::cos(angleRad);
+        node->sinAngle = std::sin(angleRad);
+    }
+}
+
+void SceneStore::setPivot(SceneHandle handle, int x, int y) {
+    if (Node *node = resolve(handle)) {
+        node->pivotX = x;
+        node->pivotY = y;
+    }
+}
+
+void SceneStore::setColor(SceneHandle handle, const Color &color) {
+    if (Node *node = resolve(handle))
+        node->color = color;
+}
+
+void SceneStore::setZ(SceneHandle handle, int z) {
+    if (Node *node = resolve(handle)) {
+        node->z = z;
+        orderDirty = true;
+    }
+}
+
+Bounds SceneStore::bounds(SceneHandle handle) const {
+    return resolve(handle) ? nodeBounds[handle.index] : Bounds();
+}
+
+void SceneStore::rebuildOrder() {
+    transformOrder.clear();
+    drawOrder.clear();
+    for (uint32_t index = 0; index < nodes.size(); index++) {
+        if (!nodes[index].alive)
+            continue;
+        transformOrder.push_back(index);
+        if (nodes[index].kind != Kind::Group)
+            drawOrder.push_back(index);
+    }
+
+    std::stable_sort(transformOrder.begin(), transformOrder.end(),
+                     [this](uint32_t a, uint32_t b) {
+                         return nodes[a].depth < nodes[b].depth;
+                     });
+    std::sort(drawOrder.begin(), drawOrder.end(),
+              [this](uint32_t a, uint32_t b) {
+                  const Node &na = nodes[a];
+                  const Node &nb = nodes[b];
+                  return na.z != nb.z ? na.z < nb.z
+                                      : na.sequence < nb.sequence;
+              });
+    orderDirty = false;
+}
+
+void SceneStore::updateTransforms() {
+    for (uint32_t index : transformOrder) {
+        const Node &node = nodes[index];
+        float c = node.cosAngle;
+        float s = node.sinAngle;
+        float px = static_cast<float>(node.pivotX);
+        float py = static_cast<float>(node.pivotY);
+
+        // Same local transform as Shape::localMatrix().
+        Matrix2D local;
+        local.a = c;
+        local.b = -s;
+        local.c = s;
+        local.d = c;
+        local.e = node.x + px * (1.0f - c) - py * s;
+        local.f = node.y + py * (1.0f - c) + px * s;
+
+        world[index] = node.parent == SceneHandle::None
+                           ? local
+                           : multiplyMatrices(world[node.parent], local);
+    }
+}
+
+static std::array<std::pair<int, int>, 4>
+rectangleVertices(const Matrix2D &m, int width, int height) {
+    std::array<std::pair<int, int>, 4> v;
+    transformPoint(0, 0, m, v[0].first, v[0].second);
+    transformPoint(0, height - 1, m, v[1].first, v[1].second);
+    transformPoint(width - 1, height - 1, m, v[2].first, v[2].second);
+    transformPoint(width - 1, 0, m, v[3].first, v[3].second);
+    return v;
+}
+
+Bounds SceneStore::primitiveBounds(const Node &node) const {
+    const Matrix2D &m = world[&node - nodes.data()];
+    Bounds bounds;
+    int x0, y0, x1, y1;
+
+    switch (node.kind) {
+    case Kind::Circle: {
+        int reach = circles[node.data].radius + 1;
+        transformPoint(0, 0, m, x0, y0);
+        return {x0 - reach, y0 - reach, x0 + reach, y0 + reach};
+    }
+    case Kind::Rectangle: {
+        const RectangleData &rect = rectangles[node.data];
+        for (const auto &v : rectangleVertices(m, rect.width, rect.height))
+            bounds.expand(v.first, v.second);
+        return bounds.padded(1);
+    }
+    case Kind::Line: {
+        const LineData &line = lines[node.data];
+        transformPoint(0, 0, m, x0, y0);
+        transformPoint(line.dx, line.dy, m, x1, y1);
+        bounds.expand(x0, y0);
+        bounds.expand(x1, y1);
+        return bounds.padded(1);
+    }
+    case Kind::Group:
+        break;
+    }
+    return bounds;
+}
+
+void SceneStore::draw(Display &target, const DrawOptions &options) {
+    if (orderDirty)
+        rebuildOrder();
+    updateTransforms();
+
+    Bounds screen = target.bounds();
+    for (uint32_t index : drawOrder) {
+        const Node &node = nodes[index];
+        nodeBounds[index] = primitiveBounds(node);
+        if (!nodeBounds[index].intersects(screen))
+            continue;
+
+        const Matrix2D &m = world[index];
+        PaintCtx ctx{node.color, nullptr, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        int x0, y0, x1, y1;
+
+        switch (node.kind) {
+        case Kind::Circle: {
+            const CircleData &circle = circles[node.data];
+            transformPoint(0, 0, m, x0, y0);
+            if (options.antialias)
+                aaCircle(target, x0, y0, circle.radius, circle.fill, ctx);
+            else
+                midpointCircle(target, x0, y0, circle.radius, ctx);
+            break;
+        }
+        case Kind::Rectangle: {
+            const RectangleData &rect = rectangles[node.data];
+            auto v = rectangleVertices(m, rect.width, rect.height);
+            auto line = options.antialias ? wuLine : bresenhamLine;
+            line(target, v[0].first, v[0].second, v[3].first, v[3].second,
+                 ctx);
+            line(target, v[1].first, v[1].second, v[2].first, v[2].second,
+                 ctx);
+            line(target, v[0].first, v[0].second, v[1].first, v[1].second,
+                 ctx);
+            line(target, v[3].first, v[3].second, v[2].first, v[2].second,
+                 ctx);
+            if (rect.fill)
+                scanlineFill(target, v, ctx);
+            break;
+        }
+        case Kind::Line: {
+            const LineData &line = lines[node.data];
+            transformPoint(0, 0, m, x0, y0);
+            transformPoint(line.dx, line.dy, m, x1, y1);
+            if (options.antialias)
+                wuLine(target, x0, y0, x1, y1, ctx);
+            else
+                bresenhamLine(target, x0, y0, x1, y1, ctx);
+            break;
+        }
+        case Kind::Group:
+            break;
+        }
+    }
+}
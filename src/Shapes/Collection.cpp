@@ -1,4 +1,5 @@
 #include "Shapes/Collection.hpp"
+#include <algorithm>
 #include <memory>
 
 Collection::Collection(const ShapeParams &params) : Shape(params) {}
@@ -10,12 +11,16 @@ std::unique_ptr<Collider> Collection::defaultCollider() {
 }
 
 void Collection::markDirty() {
-    if (_isDirty)
+    if (_isDirty) {
+        // Children were already notified; only the bounds chain may be stale
+        // (e.g. when the collection is attached to a new parent).
+        invalidateBounds();
         return;
+    }
 
     Shape::markDirty();
 
-    for (std::shared_ptr<Shape> child : shapes) {
+    for (const auto &child : shapes) {
         if (child != nullptr) {
             child->markDirty();
         }
@@ -33,7 +38,7 @@ void Collection::addShape(std::shared_ptr<Shape> shape) {
 void Collection::removeShape(std::shared_ptr<Shape> shape) {
     auto it = std::remove(shapes.begin(), shapes.end(), shape);
     if (it != shapes.end()) {
-        (*it)->setParent(nullptr);
+        shape->setParent(nullptr);
         shapes.erase(it, shapes.end());
         this->needsSort = true;
     }
@@ -49,38 +54,163 @@ void Collection::clear() {
     this->needsSort = true;
 }
 
-void Collection::drawAliased(Display &displayGrid) {
-    if (this->needsSort) {
-        this->cachedSortedShapes = shapes;
-        std::sort(this->cachedSortedShapes.begin(),
-                  this->cachedSortedShapes.end(),
-                  [](const std::shared_ptr<Shape> &a,
-                     const std::shared_ptr<Shape> &b) {
-                      return a->z() < b->z();
-                  });
-        this->needsSort = false;
+void Collection::sortIfNeeded() {
+    if (!this->needsSort)
+        return;
+
+    this->cachedSortedShapes.clear();
+    for (const auto &shape : shapes)
+        this->cachedSortedShapes.push_back(shape.get());
+    std::stable_sort(this->cachedSortedShapes.begin(),
+                     this->cachedSortedShapes.end(),
+                     [](const Shape *a, const Shape *b) {
+                         return a->z() < b->z();
+                     });
+    this->needsSort = false;
+}
+
+Bounds Collection::computeBounds() {
+    Bounds bounds;
+    for (const auto &shape : shapes) {
+        if (shape)
+            bounds.expand(shape->bounds());
+    }
+    return bounds;
+}
+
+void Collection::collectDrawables(std::vector<Shape *> &out,
+                                  const DrawOptions &options) {
+    if (!bounds().intersects(options.screen()))
+        return;
+
+    if (cacheable) {
+        // The whole collection becomes one drawable that blits its layer.
+        if (!layerValid || layerAntialias != options.antialias ||
+            layerClip != options.screen())
+            buildLayer(options.screen(), options.antialias);
+        out.push_back(this);
+        return;
     }
 
+    sortIfNeeded();
+
     for (const auto &shape : this->cachedSortedShapes) {
         if (shape)
-            shape->drawAliased(displayGrid);
+            shape->collectDrawables(out, options);
     }
 }
 
+void Collection::drawChildren(Display &displayGrid, bool antialias) {
+    sortIfNeeded();
+
+    Bounds screen = displayGrid.bounds();
+    for (const auto &shape : this->cachedSortedShapes) {
+        if (shape && shape->bounds().intersects(screen)) {
+            shape->prepareDraw();
+            if (antialias)
+                shape->drawAntiAliased(displayGrid);
+            else
+                shape->drawAliased(displayGrid);
+        }
+    }
+}
+
+void Collection::drawAliased(Display &displayGrid) {
+    if (cacheable)
+        drawLayer(displayGrid, false);
+    else
+        drawChildren(displayGrid, false);
+}
+
 void Collection::drawAntiAliased(Display &displayGrid) {
-    if (this->needsSort) {
-        this->cachedSortedShapes = shapes;
-        std::sort(this->cachedSortedShapes.begin(),
-                  this->cachedSortedShapes.end(),
-                  [](const std::shared_ptr<Shape> &a,
-                     const std::shared_ptr<Shape> &b) {
-                      return a->z() < b->z();
-                  });
-        this->needsSort = false;
+    if (cacheable)
+        drawLayer(displayGrid, true);
+    else
+        drawChildren(displayGrid, true);
+}
+
+void Collection::setCacheable(bool cacheable) {
+    this->cacheable = cacheable;
+    layerValid = false;
+    if (!cacheable) {
+        layer.pixels.clear();
+        layer.pixels.shrink_to_fit();
+        layerRuns.clear();
+        layerRuns.shrink_to_fit();
     }
+    requestRedraw();
+}
 
-    for (const auto &shape : this->cachedSortedShapes) {
-        if (shape)
-            shape->drawAntiAliased(displayGrid);
+void Collection::onDescendantChanged() {
+    layerValid = false;
+    _needsRedraw = true;
+}
+
+void Collection::drawLayer(Display &displayGrid, bool antialias) {
+    // Tiled rendering builds the layer in collectDrawables() on the calling
+    // thread, so region workers only ever blit here.
+    if (!layerValid || layerAntialias != antialias)
+        buildLayer(displayGrid.bounds(), antialias);
+    blitLayer(displayGrid);
+}
+
+void Collection::buildLayer(const Bounds &clip, bool antialias) {
+    Bounds area = bounds().intersection(clip);
+    layerValid = true;
+    layerAntialias = antialias;
+    layerClip = clip;
+    layerRuns.clear();
+
+    if (area.empty()) {
+        layer.width = layer.height = 0;
+        layer.pixels.clear();
+        return;
+    }
+
+    layer.width = area.maxX - area.minX + 1;
+    layer.height = area.maxY - area.minY + 1;
+    layer.originX = area.minX;
+    layer.originY = area.minY;
+    layer.pixels.assign(layer.width * layer.height, PixelFormat::transparent());
+
+    drawChildren(layer, antialias);
+
+    for (int y = 0; y < layer.height; y++) {
+        const Pixel *row = &layer.pixels[y * layer.width];
+        int x = 0;
+        while (x < layer.width) {
+            while (x < layer.width && PixelFormat::isTransparent(row[x]))
+                x++;
+            int start = x;
+            while (x < layer.width && !PixelFormat::isTransparent(row[x]))
+                x++;
+            if (x > start)
+                layerRuns.push_back({start, y, x - start});
+        }
+    }
+}
+
+void Collection::blitLayer(Display &displayGrid) const {
+    Bounds target = displayGrid.bounds();
+    int top = std::max(0, target.minY - layer.originY);
+    int bottom = std::min(layer.height - 1, target.maxY - layer.originY);
+
+    auto run = std::lower_bound(
+        layerRuns.begin(), layerRuns.end(), top,
+        [](const LayerRun &r, int y) { return r.y < y; });
+    for (; run != layerRuns.end() && run->y <= bottom; ++run) {
+        int minX = std::max(layer.originX + run->x, target.minX);
+        int maxX = std::min(layer.originX + run->x + run->length - 1,
+                            target.maxX);
+        if (minX > maxX)
+            continue;
+
+        const Pixel *src =
+            &layer.pixels[run->y * layer.width + (minX - layer.originX)];
+        int screenY = layer.originY + run->y;
+        Pixel *dst = &displayGrid.pixels[(screenY - target.minY) *
+                                             displayGrid.width +
+                                         (minX - target.minX)];
+        std::copy(src, src + (maxX - minX + 1), dst);
     }
 }
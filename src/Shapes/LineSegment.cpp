@@ -9,6 +9,19 @@ std::unique_ptr<Collider> LineSegment::defaultCollider() {
     return std::make_unique<LineSegmentCollider>(_x, _y, x2, y2);
 }
 
+Bounds LineSegment::computeBounds() {
+    Matrix2D mat = globalMatrix();
+
+    int x0, y0, x1, y1;
+    transformPoint(0, 0, mat, x0, y0);
+    transformPoint(x2 - _x, y2 - _y, mat, x1, y1);
+
+    Bounds bounds;
+    bounds.expand(x0, y0);
+    bounds.expand(x1, y1);
+    return bounds.padded(1);
+}
+
 void LineSegment::drawAliased(Display &displayGrid) {
     Matrix2D mat = globalMatrix();
 
@@ -8,6 +8,11 @@ std::unique_ptr<Collider> Point::defaultCollider() {
     return std::make_unique<PointCollider>(_x, _y);
 }
 
+Bounds Point::computeBounds() {
+    int x = _x, y = _y;
+    return {x, y, x, y};
+}
+
 void Point::drawAntiAliased(Display &displayGrid) {
     addPixel(displayGrid, _x, _y, 1.0f, makePaintCtx());
 }
@@ -4,7 +4,8 @@
 #include <numbers>
 
 Polygon::Polygon(const PolygonParams &params)
-    : Shape(params), vertices(params.vertices), fill(params.fill) {}
+    : Shape(params), vertices(params.vertices), fill(params.fill),
+      _fillRule(params.fillRule) {}
 
 std::unique_ptr<Collider> Polygon::defaultCollider() {
     return std::make_unique<PolygonCollider>(_x, _y, vertices);
@@ -24,6 +25,13 @@ std::vector<std::pair<int, int>> Polygon::getTransformedVertices() {
     return transformed;
 }
 
+Bounds Polygon::computeBounds() {
+    Bounds bounds;
+    for (const auto &v : getTransformedVertices())
+        bounds.expand(v.first, v.second);
+    return bounds.padded(1);
+}
+
 void Polygon::drawAliased(Display &displayGrid) {
     auto ctx = makePaintCtx();
     auto transformedVertices = getTransformedVertices();
@@ -39,7 +47,7 @@ void Polygon::drawAliased(Display &displayGrid) {
     }
 
     if (fill)
-        scanlineFill(displayGrid, transformedVertices, ctx);
+        scanlineFill(displayGrid, transformedVertices, ctx, _fillRule);
 }
 
 void Polygon::drawAntiAliased(Display &displayGrid) {
@@ -56,5 +64,5 @@ void Polygon::drawAntiAliased(Display &displayGrid) {
     }
 
     if (fill)
-        scanlineFill(displayGrid, transformedVertices, ctx);
+        scanlineFill(displayGrid, transformedVertices, ctx, _fillRule);
 }
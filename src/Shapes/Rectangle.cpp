@@ -28,6 +28,13 @@ std::array<std::pair<int, int>, 4> Rectangle::getVertices() {
             std::pair<int, int>{x2, y2}, std::pair<int, int>{x3, y3}};
 }
 
+Bounds Rectangle::computeBounds() {
+    Bounds bounds;
+    for (const auto &v : getVertices())
+        bounds.expand(v.first, v.second);
+    return bounds.padded(1);
+}
+
 void Rectangle::drawAntiAliased(Display &displayGrid) {
     auto ctx = makePaintCtx();
     auto vertices = getVertices();
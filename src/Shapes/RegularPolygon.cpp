@@ -39,12 +39,14 @@ void RegularPolygon::updateLocalVertices() {
 void RegularPolygon::setSides(int sides) {
     _sides = sides;
     localVerticesValid = false;
+    markDirty();
 }
 
 void RegularPolygon::setRadius(int radius) {
     _radius = radius;
     useSideLength = false;
     localVerticesValid = false;
+    markDirty();
 }
 
 int RegularPolygon::calculateRadiusFromSideLength(int sideLength) {
@@ -74,6 +76,13 @@ std::vector<std::pair<int, int>> RegularPolygon::getVertices() {
     return transformedVertices;
 }
 
+Bounds RegularPolygon::computeBounds() {
+    Bounds bounds;
+    for (const auto &v : getVertices())
+        bounds.expand(v.first, v.second);
+    return bounds.padded(1);
+}
+
 void RegularPolygon::drawAliased(Display &displayGrid) {
     auto ctx = makePaintCtx();
     auto vertices = getVertices();
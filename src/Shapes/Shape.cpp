@@ -155,6 +155,8 @@ void Shape::updateTextureMatrix() {
 
 void Shape::addCollider(std::unique_ptr<Collider> collider) {
     _collider = collider ? std::move(collider) : defaultCollider();
+    if (_collider)
+        _collider->shape = this;
 }
 
 void Shape::removeCollider() {
@@ -168,6 +170,14 @@ bool Shape::intersects(const std::shared_ptr<Shape> &other) {
     return false;
 }
 
+bool Shape::collide(const std::shared_ptr<Shape> &other, Contact *contact) {
+    if (_collider && other && other->_collider)
+        return _collider->collide(other->_collider.get(), contact);
+    if (contact)
+        *contact = Contact();
+    return false;
+}
+
 void Shape::setPosition(int x, int y) {
     _x = x;
     _y = y;
@@ -206,7 +216,10 @@ void Shape::setPivot(int x, int y) {
     markDirty();
 }
 
-void Shape::setZ(int z) { _z = z; }
+void Shape::setZ(int z) {
+    _z = z;
+    requestRedraw();
+}
 
 void Shape::setScale(float scaleX, float scaleY, float originX, float originY) {
     _scale.x = scaleX;
@@ -238,28 +251,44 @@ void Shape::setScaleOrigin(int x, int y) {
     _scale.originY = y;
 }
 
-void Shape::setTexture(Texture *texture) { _texture = texture; }
+void Shape::setTexture(Texture *texture) {
+    _texture = texture;
+    requestRedraw();
+}
 
 void Shape::setTextureScale(float scaleX, float scaleY) {
     _uvTransform.scaleX = scaleX;
     _uvTransform.scaleY = scaleY;
     _uvTransform.invScaleX = 1.0f / scaleX;
     _uvTransform.invScaleY = 1.0f / scaleY;
+    requestRedraw();
 }
 
 void Shape::setTextureOffset(float offsetX, float offsetY) {
     _uvTransform.offsetX = offsetX;
     _uvTransform.offsetY = offsetY;
+    requestRedraw();
 }
 
 void Shape::setTextureRotation(float rotation) {
     _uvTransform.rotation = rotation;
     invalidateTexTrigCache();
+    requestRedraw();
 }
 
-void Shape::setFixTexture(bool fixed) { _fixTexture = fixed; }
+void Shape::setFixTexture(bool fixed) {
+    _fixTexture = fixed;
+    requestRedraw();
+}
 
-void Shape::setParent(Shape *parent) { _parent = parent; }
+void Shape::setParent(Shape *parent) {
+    if (_parent) {
+        _parent->invalidateBounds();
+        notifyAncestors();
+    }
+    _parent = parent;
+    markDirty();
+}
 
 PaintCtx Shape::makePaintCtx() const {
     return {_color, _texture, _tex_A, _tex_B, _tex_C, _tex_D, _tex_E, _tex_F};
@@ -272,7 +301,32 @@ std::pair<int, int> Shape::getTransformedPosition(int inputX, int inputY) {
     return {outX, outY};
 }
 
-void Shape::draw(Display &displayGrid, const DrawOptions &options) {
+void Shape::invalidateBounds() {
+    _boundsValid = false;
+    for (Shape *p = _parent; p && p->_boundsValid; p = p->_parent)
+        p->_boundsValid = false;
+}
+
+void Shape::notifyAncestors() {
+    for (Shape *p = _parent; p; p = p->_parent)
+        p->onDescendantChanged();
+}
+
+const Bounds &Shape::bounds() {
+    if (!_boundsValid) {
+        _cachedBounds = computeBounds();
+        _boundsValid = true;
+    }
+    return _cachedBounds;
+}
+
+void Shape::collectDrawables(std::vector<Shape *> &out,
+                             const DrawOptions &options) {
+    if (bounds().intersects(options.screen()))
+        out.push_back(this);
+}
+
+void Shape::prepareDraw() {
     float localPivotX = (float)_rotation.x - _x;
     float localPivotY = (float)_rotation.y - _y;
     auto pivotInt = getTransformedPosition(localPivotX, localPivotY);
@@ -282,6 +336,11 @@ void Shape::draw(Display &displayGrid, const DrawOptions &options) {
 
     if (_texture)
         updateTextureMatrix();
+}
 
+void Shape::draw(Display &displayGrid, const DrawOptions &options) {
+    if (!bounds().intersects(displayGrid.bounds()))
+        return;
+    prepareDraw();
     options.antialias ? drawAntiAliased(displayGrid) : drawAliased(displayGrid);
 }
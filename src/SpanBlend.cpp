@@ -0,0 +1,213 @@
+#include "SpanBlend.hpp"
+#include <algorithm>
+#include <cstring>
+
+// The vector kernels operate on packed RGBA8888 and are compiled only for
+// that format; the other formats run the scalar loops through load/store.
+#if RENDERER_PIXEL_FORMAT == RENDERER_PIXEL_RGBA8888
+#if defined(__SSE2__)
+#define SPAN_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define SPAN_AVX2 1
+#include <immintrin.h>
+#endif
+static_assert(sizeof(Pixel) == 4, "span kernels assume packed RGBA8888");
+#endif
+
+static inline void blendPixel(Pixel *p, const Color &s, uint32_t alpha) {
+    uint32_t invAlpha = 255 - alpha;
+    Color d = PixelFormat::load(*p);
+    d.r = (s.r * alpha + d.r * invAlpha) >> 8;
+    d.g = (s.g * alpha + d.g * invAlpha) >> 8;
+    d.b = (s.b * alpha + d.b * invAlpha) >> 8;
+    *p = PixelFormat::store(d);
+}
+
+void blendSolidSpan(Pixel *dst, int count, const Color &color,
+                    uint8_t alpha) {
+    if (count <= 0 || alpha == 0)
+        return;
+
+    if (alpha == 255) {
+        std::fill_n(dst, count, PixelFormat::store(color));
+        return;
+    }
+
+    int i = 0;
+
+#if defined(SPAN_AVX2) || defined(SPAN_SSE2)
+    // Per channel: premultiplied source, up to 255 * 254, in the low 16
+    // bits of each lane, alpha lane zeroed and forced to 255 afterwards.
+    // The lanes are used as unsigned; the set intrinsics take shorts.
+    const uint16_t pr = color.r * alpha, pg = color.g * alpha,
+                   pb = color.b * alpha;
+    const uint16_t inv = 255 - alpha;
+    const short r = static_cast<short>(pr), g = static_cast<short>(pg),
+                b = static_cast<short>(pb);
+#endif
+
+#if defined(SPAN_AVX2)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i premul = _mm256_setr_epi16(r, g, b, 0, r, g, b, 0, r, g,
+                                                 b, 0, r, g, b, 0);
+        const __m256i invAlpha = _mm256_set1_epi16(static_cast<short>(inv));
+        const __m256i alphaMask = _mm256_set1_epi32(0xFF000000);
+
+        for (; i + 8 <= count; i += 8) {
+            __m256i px =
+                _mm256_loadu_si256(reinterpret_cast<__m256i *>(dst + i));
+            __m256i lo = _mm256_unpacklo_epi8(px, zero);
+            __m256i hi = _mm256_unpackhi_epi8(px, zero);
+            lo = _mm256_srli_epi16(
+                _mm256_add_epi16(_mm256_mullo_epi16(lo, invAlpha), premul), 8);
+            hi = _mm256_srli_epi16(
+                _mm256_add_epi16(_mm256_mullo_epi16(hi, invAlpha), premul), 8);
+            px = _mm256_or_si256(_mm256_packus_epi16(lo, hi), alphaMask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), px);
+        }
+    }
+#endif
+
+#if defined(SPAN_SSE2)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i premul = _mm_setr_epi16(r, g, b, 0, r, g, b, 0);
+        const __m128i invAlpha = _mm_set1_epi16(static_cast<short>(inv));
+        const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+
+        for (; i + 4 <= count; i += 4) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<__m128i *>(dst + i));
+            __m128i lo = _mm_unpacklo_epi8(px, zero);
+            __m128i hi = _mm_unpackhi_epi8(px, zero);
+            lo = _mm_srli_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(lo, invAlpha), premul), 8);
+            hi = _mm_srli_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(hi, invAlpha), premul), 8);
+            px = _mm_or_si128(_mm_packus_epi16(lo, hi), alphaMask);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), px);
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+        blendPixel(dst + i, color, alpha);
+}
+
+#if defined(SPAN_SSE2)
+// Blends two unpacked pixels (8 x u16) of src over dst.
+static inline __m128i blendPair(__m128i s, __m128i d) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i alphaLanes = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF);
+    __m128i blended = _mm_srli_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(s, a),
+                      _mm_mullo_epi16(d, _mm_sub_epi16(full, a))),
+        8);
+    blended = _mm_or_si128(blended, alphaLanes);
+
+    // Opaque source pixels are stored unchanged, transparent ones leave the
+    // destination untouched.
+    __m128i opaque = _mm_cmpeq_epi16(a, full);
+    __m128i transparent = _mm_cmpeq_epi16(a, zero);
+    blended = _mm_or_si128(_mm_and_si128(opaque, s),
+                           _mm_andnot_si128(opaque, blended));
+    return _mm_or_si128(_mm_and_si128(transparent, d),
+                        _mm_andnot_si128(transparent, blended));
+}
+#endif
+
+#if defined(SPAN_AVX2)
+// blendPair() on four unpacked pixels (16 x u16).
+static inline __m256i blendQuad(__m256i s, __m256i d) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i full = _mm256_set1_epi16(255);
+    const __m256i alphaLanes = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255,
+                                                 0, 0, 0, 255, 0, 0, 0, 255);
+
+    __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xFF), 0xFF);
+    __m256i blended = _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_mullo_epi16(s, a),
+                         _mm256_mullo_epi16(d, _mm256_sub_epi16(full, a))),
+        8);
+    blended = _mm256_or_si256(blended, alphaLanes);
+
+    __m256i opaque = _mm256_cmpeq_epi16(a, full);
+    __m256i transparent = _mm256_cmpeq_epi16(a, zero);
+    blended = _mm256_or_si256(_mm256_and_si256(opaque, s),
+                              _mm256_andnot_si256(opaque, blended));
+    return _mm256_or_si256(_mm256_and_si256(transparent, d),
+                           _mm256_andnot_si256(transparent, blended));
+}
+#endif
+
+void blendSpan(Pixel *dst, const Color *src, int count) {
+    int i = 0;
+
+#if defined(SPAN_AVX2)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i alphaMask = _mm256_set1_epi32(0xFF000000);
+
+        for (; i + 8 <= count; i += 8) {
+            __m256i s =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+            __m256i sa = _mm256_and_si256(s, alphaMask);
+
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, alphaMask)) ==
+                -1) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), s);
+                continue;
+            }
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, zero)) == -1)
+                continue;
+
+            __m256i d =
+                _mm256_loadu_si256(reinterpret_cast<__m256i *>(dst + i));
+            __m256i lo = blendQuad(_mm256_unpacklo_epi8(s, zero),
+                                   _mm256_unpacklo_epi8(d, zero));
+            __m256i hi = blendQuad(_mm256_unpackhi_epi8(s, zero),
+                                   _mm256_unpackhi_epi8(d, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                                _mm256_packus_epi16(lo, hi));
+        }
+    }
+#endif
+
+#if defined(SPAN_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i sa = _mm_and_si128(s, alphaMask);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, alphaMask)) == 0xFFFF) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), s);
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, zero)) == 0xFFFF)
+            continue;
+
+        __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i *>(dst + i));
+        __m128i lo = blendPair(_mm_unpacklo_epi8(s, zero),
+                               _mm_unpacklo_epi8(d, zero));
+        __m128i hi = blendPair(_mm_unpackhi_epi8(s, zero),
+                               _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                         _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < count; i++) {
+        if (src[i].a == 255) {
+            dst[i] = PixelFormat::store(src[i]);
+        } else if (src[i].a != 0) {
+            blendPixel(dst + i, src[i], src[i].a);
+        }
+    }
+}
@@ -1,5 +1,7 @@
 #include "Texture.hpp"
 #include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
@@ -9,12 +11,21 @@ namespace fs = std::filesystem;
 
 static const char *TAG = "Texture";
 
+static bool isPowerOfTwo(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
 Texture::Texture(const std::vector<Color, PsramAllocator<Color>> &pixels,
                  int width, int height)
-    : pixels(pixels), width(width), height(height), wrapMode("repeat"),
-      valid(true) {}
+    : pixels(pixels), width(width), height(height),
+      wrapMode(WrapMode::Repeat), valid(true), widthShift(-1) {
+    if (isPowerOfTwo(width) && isPowerOfTwo(height))
+        widthShift = std::countr_zero(static_cast<unsigned>(width));
+}
 
-Texture::Texture() : width(0), height(0), wrapMode("repeat"), valid(false) {}
+Texture::Texture()
+    : width(0), height(0), wrapMode(WrapMode::Repeat), valid(false),
+      widthShift(-1) {}
 
 bool Texture::readFile(const std::string &filename,
                        std::vector<uint8_t> &buffer) {
@@ -170,39 +181,77 @@ bool Texture::fromBMP(const std::string &filename, Texture &outTexture,
 }
 
 Color Texture::sample(int u, int v) const {
-    if (!valid || pixels.empty() || width == 0 || height == 0) {
-        return Color(0, 0, 0, 255);
-    }
-    int x = u;
-    int y = v;
-
-    if (wrapMode == "repeat") {
-        if (u >= 0 && u < width && v >= 0 && v < height) {
-            return pixels[y * width + x];
-        } else {
-            x = u % width;
-            y = v % height;
-            if (x < 0)
-                x += width;
-            if (y < 0)
-                y += height;
-        }
-    } else {
-        x = std::max(0, std::min(width - 1, x));
-        y = std::max(0, std::min(height - 1, y));
+    Color texel;
+    withSampler([&](const auto &sampler) { texel = sampler.at(u, v); });
+    return texel;
+}
+
+void Texture::generateMipmaps() {
+    mips.clear();
+    if (!valid || pixels.empty())
+        return;
+    // Halving an odd size drops a row or column, after which the levels no
+    // longer tile with the same period as the base texture.
+    if (!isPowerOfTwo(width) || !isPowerOfTwo(height)) {
+        RENDERER_LOGW(TAG, "No mipmaps for non-power-of-two %dx%d texture",
+                      width, height);
+        return;
     }
 
-    if (y >= 0 && y < height && x >= 0 && x < width) {
-        return pixels[y * width + x];
+    const Color *source = pixels.data();
+    int sourceWidth = width;
+    int sourceHeight = height;
+    while (sourceWidth > 1 || sourceHeight > 1) {
+        MipLevel level;
+        level.width = std::max(1, sourceWidth / 2);
+        level.height = std::max(1, sourceHeight / 2);
+        level.widthShift =
+            std::countr_zero(static_cast<unsigned>(level.width));
+        level.pixels.resize(level.width * level.height);
+
+        // A side already at 1 texel repeats its row or column.
+        for (int y = 0; y < level.height; y++) {
+            int y0 = std::min(2 * y, sourceHeight - 1);
+            int y1 = std::min(2 * y + 1, sourceHeight - 1);
+            for (int x = 0; x < level.width; x++) {
+                int x0 = std::min(2 * x, sourceWidth - 1);
+                int x1 = std::min(2 * x + 1, sourceWidth - 1);
+                const Color &a = source[y0 * sourceWidth + x0];
+                const Color &b = source[y0 * sourceWidth + x1];
+                const Color &c = source[y1 * sourceWidth + x0];
+                const Color &d = source[y1 * sourceWidth + x1];
+                level.pixels[y * level.width + x] =
+                    Color((a.r + b.r + c.r + d.r + 2) >> 2,
+                          (a.g + b.g + c.g + d.g + 2) >> 2,
+                          (a.b + b.b + c.b + d.b + 2) >> 2,
+                          (a.a + b.a + c.a + d.a + 2) >> 2);
+            }
+        }
+
+        mips.push_back(std::move(level));
+        source = mips.back().pixels.data();
+        sourceWidth = mips.back().width;
+        sourceHeight = mips.back().height;
     }
-    return Color(0, 0, 0, 255);
+    RENDERER_LOGI(TAG, "Built %d mip levels for %dx%d texture", mipLevels(),
+                  width, height);
+}
+
+int Texture::mipLevelFor(float texelsPerPixel) const {
+    if (mips.empty() || !(texelsPerPixel >= 2.0f))
+        return 0;
+    // floor(log2()), so a level is used once it has at least one texel per
+    // pixel.
+    return std::min(std::ilogb(texelsPerPixel), mipLevels());
 }
 
 void Texture::setWrapMode(const std::string &mode) {
-    if (mode == "repeat" || mode == "clamp") {
-        wrapMode = mode;
+    if (mode == "repeat") {
+        wrapMode = WrapMode::Repeat;
+    } else if (mode == "clamp") {
+        wrapMode = WrapMode::Clamp;
     } else {
         RENDERER_LOGW(TAG, "Invalid wrap mode: %s, using 'repeat'", mode.c_str());
-        wrapMode = "repeat";
+        wrapMode = WrapMode::Repeat;
     }
 }
@@ -0,0 +1,127 @@
+#include "TextureAtlas.hpp"
+#include <algorithm>
+#include <bit>
+#include <climits>
+
+static const char *TAG = "TextureAtlas";
+
+TextureAtlas::TextureAtlas(int width, int height)
+    : page(std::vector<Color, PsramAllocator<Color>>(
+               std::max(width, 0) * std::max(height, 0), Color(0, 0, 0, 0)),
+           std::max(width, 0), std::max(height, 0)) {
+    if (page.width > 0)
+        skyline.push_back({0, 0, page.width});
+}
+
+float TextureAtlas::occupancy() const {
+    long area = static_cast<long>(page.width) * page.height;
+    return area > 0 ? static_cast<float>(usedArea) / area : 0.0f;
+}
+
+Texture *TextureAtlas::add(const Texture &texture) {
+    if (!texture.isValid() || texture.getWidth() <= 0 ||
+        texture.getHeight() <= 0)
+        return nullptr;
+    int width = texture.getWidth();
+    int height = texture.getHeight();
+    int x, y;
+    if (!findPosition(width, height, x, y)) {
+        RENDERER_LOGW(TAG, "No room for %dx%d texture in %dx%d atlas", width,
+                      height, page.width, page.height);
+        return nullptr;
+    }
+    place(x, y, width, height);
+
+    texture.withSampler([&](const auto &sampler) {
+        for (int row = 0; row < height; row++) {
+            Color *dst = page.pixels.data() + (y + row) * page.width + x;
+            for (int column = 0; column < width; column++)
+                dst[column] = sampler.at(column, row);
+        }
+    });
+
+    auto region = std::make_unique<Texture>();
+    region->width = width;
+    region->height = height;
+    region->valid = true;
+    region->page = &page;
+    region->originX = x;
+    region->originY = y;
+    auto powerOfTwo = [](int value) {
+        return std::has_single_bit(static_cast<unsigned>(value));
+    };
+    if (powerOfTwo(width) && powerOfTwo(height) && powerOfTwo(page.width))
+        region->widthShift =
+            std::countr_zero(static_cast<unsigned>(page.width));
+
+    usedArea += static_cast<long>(width) * height;
+    regions.push_back(std::move(region));
+    return regions.back().get();
+}
+
+Texture *TextureAtlas::addBMP(const std::string &filename, bool littleEndian) {
+    Texture texture;
+    if (!Texture::fromBMP(filename, texture, littleEndian))
+        return nullptr;
+    return add(texture);
+}
+
+// Tries every skyline segment as the left edge and takes the lowest spot,
+// then the leftmost.
+bool TextureAtlas::findPosition(int width, int height, int &outX,
+                                int &outY) const {
+    int bestY = INT_MAX;
+    int bestX = 0;
+    for (size_t i = 0; i < skyline.size(); i++) {
+        int x = skyline[i].x;
+        if (x + width > page.width)
+            break;
+        // Rests on the highest segment under its width.
+        int y = 0;
+        int covered = 0;
+        for (size_t j = i; covered < width; j++) {
+            y = std::max(y, skyline[j].y);
+            covered = skyline[j].x + skyline[j].width - x;
+        }
+        if (y + height <= page.height && y < bestY) {
+            bestY = y;
+            bestX = x;
+        }
+    }
+    if (bestY == INT_MAX)
+        return false;
+    outX = bestX;
+    outY = bestY;
+    return true;
+}
+
+void TextureAtlas::place(int x, int y, int width, int height) {
+    size_t i = 0;
+    while (skyline[i].x != x)
+        i++;
+    skyline.insert(skyline.begin() + i, {x, y + height, width});
+
+    // Cut the segments now covered by the new one.
+    int right = x + width;
+    size_t next = i + 1;
+    while (next < skyline.size() && skyline[next].x < right) {
+        Segment &segment = skyline[next];
+        int end = segment.x + segment.width;
+        if (end <= right) {
+            skyline.erase(skyline.begin() + next);
+        } else {
+            segment.width = end - right;
+            segment.x = right;
+            break;
+        }
+    }
+
+    for (size_t k = 0; k + 1 < skyline.size();) {
+        if (skyline[k].y == skyline[k + 1].y) {
+            skyline[k].width += skyline[k + 1].width;
+            skyline.erase(skyline.begin() + k + 1);
+        } else {
+            k++;
+        }
+    }
+}
@@ -5,3 +5,10 @@ bool operator==(const Color &lhs, const Color &rhs) {
 }
 
 bool operator!=(const Color &lhs, const Color &rhs) { return !(lhs == rhs); }
+
+bool operator==(const Bounds &lhs, const Bounds &rhs) {
+    return lhs.minX == rhs.minX && lhs.minY == rhs.minY &&
+           lhs.maxX == rhs.maxX && lhs.maxY == rhs.maxY;
+}
+
+bool operator!=(const Bounds &lhs, const Bounds &rhs) { return !(lhs == rhs); }
@@ -0,0 +1,76 @@
+#include "WorkerPool.hpp"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned workers) {
+    if (workers == 0)
+        workers = std::max(1u, std::thread::hardware_concurrency());
+
+    threads.reserve(workers - 1);
+    for (unsigned i = 1; i < workers; i++)
+        threads.emplace_back(&WorkerPool::workerLoop, this, i);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &thread : threads)
+        thread.join();
+}
+
+void WorkerPool::run(int jobCount, const Job &job) {
+    if (jobCount <= 0)
+        return;
+
+    if (threads.empty() || jobCount == 1) {
+        for (int i = 0; i < jobCount; i++)
+            job(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentJob = &job;
+        this->jobCount = jobCount;
+        nextJob.store(0, std::memory_order_relaxed);
+        busyWorkers = threads.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busyWorkers == 0; });
+    currentJob = nullptr;
+}
+
+void WorkerPool::drain(unsigned worker) {
+    int job;
+    while ((job = nextJob.fetch_add(1, std::memory_order_relaxed)) < jobCount)
+        (*currentJob)(job, worker);
+}
+
+void WorkerPool::workerLoop(unsigned worker) {
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] {
+                return stopping || generation != seenGeneration;
+            });
+            if (stopping)
+                return;
+            seenGeneration = generation;
+        }
+
+        drain(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0)
+            done.notify_one();
+    }
+}
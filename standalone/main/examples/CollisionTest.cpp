@@ -43,10 +43,13 @@ void runCollisionTest() {
 
         enemy->translate(0, 1);
 
-        if (triangle->intersects(enemy)) {
+        Contact contact;
+        if (triangle->collide(enemy, &contact)) {
             triangle->setColor(Color(255, 0, 0, 1.0f)); // Red on collision
-            printf("Collision detected at enemy position (%.2f, %.2f)\n",
-                   enemy->collider()->x, enemy->collider()->y);
+            printf("Collision detected at enemy position (%.2f, %.2f), "
+                   "penetration %.2f along (%.2f, %.2f)\n",
+                   enemy->collider()->x, enemy->collider()->y, contact.depth,
+                   contact.normalX, contact.normalY);
         } else {
             triangle->setColor(Color(0, 255, 0, 1.0f)); // Green otherwise
         }
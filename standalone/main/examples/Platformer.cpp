@@ -1,4 +1,5 @@
 #include "examples/Platformer.hpp"
+#include "CollisionWorld.hpp"
 #include "Renderer.hpp"
 #include "Shapes/Collection.hpp"
 #include "Shapes/Rectangle.hpp"
@@ -56,17 +57,22 @@ void runPlatformer() {
     mainCollection->addShape(player);
 
     // --- Platform Setup ---
-    std::vector<std::shared_ptr<Rectangle>> platforms;
+    // Platforms never move, so their collection is rasterized once and
+    // blitted on later frames.
+    auto levelCollection =
+        std::make_shared<Collection>(ShapeParams{0, 0, Color(0, 0, 0, 0), 0});
+    levelCollection->setCacheable(true);
+    CollisionWorld world;
 
     auto createPlatform = [&](int x, int y, int w, int h, Color c) {
         auto p =
             std::make_shared<Rectangle>(RectangleParams{x, y, c, w, h, true});
         p->addCollider();
-        platforms.push_back(p);
-        mainCollection->addShape(p);
+        world.add(p->collider());
+        levelCollection->addShape(p);
     };
 
-    Color platformColor(100, 180, 80, 1.0f);
+    Color platformColor(100, 180, 80, 255);
     createPlatform(0, 56, 64, 8, platformColor);  // Ground
     createPlatform(20, 46, 24, 5, platformColor); // Middle platform
     createPlatform(0, 28, 18, 5, platformColor);  // Left platform
@@ -82,6 +88,7 @@ void runPlatformer() {
     bool canJump = false;
 
     Pixels pixels;
+    std::vector<Collider *> hits;
 
     // --- Game Loop ---
     while (1) {
@@ -110,22 +117,37 @@ void runPlatformer() {
         player->translate(velocityX, 0.0f);
 
         // 2. Vertical Movement & Collision
+        // The fall is swept against the platforms below, so a fast fall
+        // cannot skip a thin platform between two frames.
         velocityY += gravity;
-        float oldPlayerY = player->y();
-        player->translate(0.0f, velocityY);
         canJump = false;
-        for (const auto& platform : platforms) {
-            if (player->intersects(platform)) {
-
-                if (velocityY > 0 &&
-                    oldPlayerY + player->height() <= platform->y() + 1) {
-                    player->setPosition(player->x(),
-                                        platform->y() - player->height());
-                    velocityY = 0;
-                    canJump = true;
+        Shape *ground = nullptr;
+        if (velocityY > 0) {
+            auto *body = static_cast<RectangleCollider *>(player->collider());
+            Aabb fall = body->aabb();
+            fall.maxY += velocityY;
+            hits.clear();
+            world.query(fall, hits);
+
+            float landingTime = 2.0f;
+            SweepHit sweep;
+            for (Collider *hit : hits) {
+                Shape *platform = hit->shape;
+                if (player->y() + player->height() <= platform->y() + 1 &&
+                    body->sweep(0.0f, velocityY, hit, &sweep) &&
+                    sweep.time < landingTime) {
+                    landingTime = sweep.time;
+                    ground = platform;
                 }
             }
         }
+        if (ground) {
+            player->setPosition(player->x(), ground->y() - player->height());
+            velocityY = 0;
+            canJump = true;
+        } else {
+            player->translate(0.0f, velocityY);
+        }
 
         // --- Screen Boundaries & Respawn ---
         if (player->x() < 0) {
@@ -141,9 +163,10 @@ void runPlatformer() {
 
         // --- Rendering ---
         pixels.clear();
-        renderer.render(
-            pixels, std::vector<std::shared_ptr<Collection>>{mainCollection},
-            options);
+        renderer.render(pixels,
+                        std::vector<std::shared_ptr<Collection>>{
+                            levelCollection, mainCollection},
+                        options);
         display.setBuffer(pixels);
 
         // --- Frame Rate Control ---